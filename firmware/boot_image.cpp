@@ -0,0 +1,181 @@
+#include "boot_image.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace boot_image {
+
+std::vector<Segment> from_ram(const uint8_t* ram, std::size_t size, std::size_t min_gap) {
+    std::vector<Segment> segments;
+    std::size_t i = 0;
+    while (i < size) {
+        while (i < size && ram[i] == 0) i++;
+        if (i == size) break;
+
+        // Extend over non-zero bytes and short gaps
+        const std::size_t start = i & ~std::size_t(1);
+        std::size_t       end   = i;
+        while (i < size) {
+            if (ram[i] != 0) {
+                end = ++i;
+                continue;
+            }
+            std::size_t z = i;
+            while (z < size && ram[z] == 0 && z - i < min_gap) z++;
+            if (z == size || z - i >= min_gap) break;
+            i = z;
+        }
+        end = std::min(size, (end + 1) & ~std::size_t(1));
+
+        Segment s;
+        s.dest = static_cast<uint32_t>(start);
+        s.data.assign(ram + start, ram + end);
+        segments.push_back(std::move(s));
+        i = end;
+    }
+    return segments;
+}
+
+std::vector<uint8_t> lz_compress(const uint8_t* data, std::size_t size) {
+    // Hash chains over 3-byte prefixes, a bounded search per position
+    constexpr int      hash_bits   = 14;
+    constexpr int      chain_limit = 256;
+    std::vector<int>   head(1 << hash_bits, -1);
+    std::vector<int>   prev(size, -1);
+    auto hash = [&](std::size_t p) {
+        return ((data[p] << 8 ^ data[p + 1] << 4 ^ data[p + 2]) * 2654435761u) >> (32 - hash_bits);
+    };
+    auto insert = [&](std::size_t p) {
+        if (p + min_match > size) return;
+        const uint32_t h = hash(p);
+        prev[p] = head[h];
+        head[h] = static_cast<int>(p);
+    };
+
+    std::vector<uint8_t> out;
+    std::size_t flag_pos = 0;
+    int         items    = 8;
+    std::size_t p        = 0;
+    while (p < size) {
+        if (items == 8) {
+            flag_pos = out.size();
+            out.push_back(0);
+            items = 0;
+        }
+
+        int best_len = 0, best_dist = 0;
+        if (p + min_match <= size) {
+            const int limit = static_cast<int>(std::min<std::size_t>(max_match, size - p));
+            int       cand  = head[hash(p)];
+            for (int n = 0; cand >= 0 && n < chain_limit; cand = prev[cand], n++) {
+                const int dist = static_cast<int>(p) - cand;
+                if (dist > window_bytes) break;
+                int len = 0;
+                while (len < limit && data[cand + len] == data[p + len]) len++;
+                if (len > best_len) {
+                    best_len  = len;
+                    best_dist = dist;
+                    if (len == limit) break;
+                }
+            }
+        }
+
+        if (best_len >= min_match) {
+            const int d = best_dist - 1;
+            out.push_back(static_cast<uint8_t>(d));
+            out.push_back(static_cast<uint8_t>((d >> 8) << 4 | (best_len - min_match)));
+            for (int k = 0; k < best_len; k++) insert(p++);
+        } else {
+            out[flag_pos] |= static_cast<uint8_t>(1u << items);
+            out.push_back(data[p]);
+            insert(p++);
+        }
+        items++;
+    }
+    return out;
+}
+
+bool lz_decompress(const uint8_t* src, std::size_t src_size, std::size_t out_size, std::vector<uint8_t>& out,
+                   std::size_t* consumed) {
+    const std::size_t base = out.size();
+    std::size_t       s    = 0;
+    uint8_t           flags = 0;
+    int               items = 0;
+    while (out.size() - base < out_size) {
+        if (items == 0) {
+            if (s >= src_size) return false;
+            flags = src[s++];
+            items = 8;
+        }
+        items--;
+        if (flags & 1) {
+            if (s >= src_size) return false;
+            out.push_back(src[s++]);
+        } else {
+            if (s + 2 > src_size) return false;
+            const std::size_t dist = (src[s] | (src[s + 1] >> 4) << 8) + 1;
+            const int         len  = (src[s + 1] & 0xF) + min_match;
+            s += 2;
+            if (dist > out.size() - base) return false;
+            for (int k = 0; k < len && out.size() - base < out_size; k++) out.push_back(out[out.size() - dist]);
+        }
+        flags >>= 1;
+    }
+    if (consumed) *consumed = s;
+    return true;
+}
+
+static void put24(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+}
+
+std::vector<uint8_t> build(const std::vector<Segment>& segments, bool compress) {
+    std::vector<uint8_t> out;
+    for (const Segment& seg : segments) {
+        if (seg.data.empty()) continue;
+        std::vector<uint8_t> payload;
+        bool                 lz = false;
+        if (compress) {
+            payload = lz_compress(seg.data.data(), seg.data.size());
+            lz      = payload.size() < seg.data.size();
+        }
+        if (!lz) payload = seg.data;
+
+        put24(out, seg.dest);
+        put24(out, static_cast<uint32_t>(seg.data.size()));
+        out.push_back(lz ? 1 : 0);
+        out.push_back(0);
+        out.insert(out.end(), payload.begin(), payload.end());
+    }
+    out.insert(out.end(), header_bytes, 0);
+    return out;
+}
+
+bool load(const uint8_t* flash, std::size_t flash_size, uint8_t* ram, std::size_t ram_size) {
+    std::size_t p = 0;
+    for (;;) {
+        if (p + header_bytes > flash_size) return false;
+        const uint8_t* h    = flash + p;
+        const uint32_t dest = h[0] | h[1] << 8 | h[2] << 16;
+        const uint32_t len  = h[3] | h[4] << 8 | h[5] << 16;
+        p += header_bytes;
+        if (len == 0 || h[7] != 0) return true;
+        if ((dest | len) & 1 || (dest & 0xFFFFF) + std::size_t(len) > ram_size) return false;
+
+        std::vector<uint8_t> data;
+        if (h[6] & 1) {
+            std::size_t used = 0;
+            if (!lz_decompress(flash + p, flash_size - p, len, data, &used)) return false;
+            p += used;
+        } else {
+            if (p + len > flash_size) return false;
+            data.assign(flash + p, flash + p + len);
+            p += len;
+        }
+        std::memcpy(ram + (dest & 0xFFFFF), data.data(), len);
+    }
+}
+
+} // namespace boot_image
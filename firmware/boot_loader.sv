@@ -0,0 +1,268 @@
+// Boot loader: after reset, streams the boot image from an SPI flash into
+// SRAM, one 16-bit word at a time through the PPU's bus master. The refresh
+// FSM lends it the bus while `active` and acknowledges each written word.
+//
+// Image format (see include/boot_image.h), from flash address 0:
+//   segments of an 8-byte header - destination byte address (3 bytes),
+//   length in bytes (3 bytes), both little endian and even, flags (bit 0 =
+//   LZ) and a reserved byte that must be 0 - each followed by its payload.
+//   A zero length or a non-zero reserved byte (erased flash) ends the image.
+// LZ payload: a flag byte, LSB first, for up to 8 items; 1 = a literal byte,
+//   0 = a match of two bytes: distance - 1 as 12 bits (low byte, then the
+//   high nibble in [7:4]) and length - 3 in [3:0], from a 4 KB window.
+//   The payload ends where the segment's length is reached.
+//
+// SPI mode 0 at clk / 2: a single READ (03h) from address 0, with SCK held
+// between bytes while the decompressor or the bus write is busy.
+//
+// Not yet simulated: check with mud16_bench --flash before relying on it.
+module boot_loader (
+    input  logic        clk,
+    input  logic        reset,
+    input  logic        boot,        // strap: load from flash after reset
+
+    output logic        active,
+
+    // SPI flash
+    output logic        spi_cs_n,
+    output logic        spi_sck,
+    output logic        spi_mosi,
+    input  logic        spi_miso,
+
+    // Words for SRAM, held until wr_ack
+    output logic        wr_valid,
+    output logic [19:0] wr_addr,
+    output logic [15:0] wr_data,
+    input  logic        wr_ack
+);
+
+    // -------------------------------------------------------------------------
+    // SPI master
+    // -------------------------------------------------------------------------
+    typedef enum logic [1:0] {
+        SPI_OFF,
+        SPI_CMD,
+        SPI_READ
+    } spi_phase_t;
+
+    spi_phase_t spi_phase;
+    reg         spi_setup;   // SCK low with the next bit set up
+    reg  [5:0]  spi_cnt;     // command bits left
+    reg  [31:0] spi_tx;
+    reg  [3:0]  rd_cnt;      // bits left of the byte being read, 0 = none
+    reg  [7:0]  spi_rx;
+    reg  [7:0]  rx_byte;
+    reg         rx_valid;
+
+    // -------------------------------------------------------------------------
+    // Image parser and LZ decompressor
+    // -------------------------------------------------------------------------
+    typedef enum logic [2:0] {
+        B_HEADER,
+        B_RAW,
+        B_FLAGS,
+        B_ITEM,
+        B_MATCH,
+        B_COPY,
+        B_WRITE,
+        B_DONE
+    } boot_state_t;
+
+    boot_state_t state;
+    boot_state_t ret_state;     // where B_WRITE continues
+
+    reg  [63:0] hdr;
+    reg  [2:0]  hdr_cnt;
+    reg  [19:0] out_addr;       // next word to write
+    reg  [23:0] out_left;       // bytes left in the segment
+    reg  [7:0]  flags;
+    reg  [3:0]  flag_cnt;       // items left under `flags`
+    reg  [7:0]  m_lo;
+    reg  [11:0] m_src;
+    reg  [4:0]  m_len;
+    reg  [7:0]  window [0:4095];
+    reg  [11:0] wpos;
+    reg  [7:0]  lo_byte;
+    reg         have_lo;
+
+    always_ff @(posedge clk) begin
+        if (reset) begin
+            active    <= boot;
+            spi_phase <= boot ? SPI_CMD : SPI_OFF;
+            spi_cs_n  <= 1;
+            spi_sck   <= 0;
+            spi_mosi  <= 0;
+            spi_setup <= 0;
+            spi_cnt   <= 32;
+            spi_tx    <= {8'h03, 24'h000000};
+            rd_cnt    <= 0;
+            rx_valid  <= 0;
+            state     <= boot ? B_HEADER : B_DONE;
+            hdr_cnt   <= 0;
+            flag_cnt  <= 0;
+            wpos      <= 0;
+            have_lo   <= 0;
+            wr_valid  <= 0;
+        end else begin
+            logic        emit;
+            logic [7:0]  emit_byte;
+            boot_state_t cont;
+            logic [63:0] full;
+
+            emit      = 0;
+            emit_byte = 0;
+            cont      = state;
+            full      = {rx_byte, hdr[63:8]};
+
+            case (spi_phase)
+                SPI_CMD: begin
+                    if (!spi_setup) begin
+                        spi_cs_n  <= 0;
+                        spi_sck   <= 0;
+                        spi_mosi  <= spi_tx[31];
+                        spi_tx    <= spi_tx << 1;
+                        spi_setup <= 1;
+                    end else begin
+                        spi_sck   <= 1; // flash samples MOSI
+                        spi_setup <= 0;
+                        spi_cnt   <= spi_cnt - 1;
+                        if (spi_cnt == 1) spi_phase <= SPI_READ;
+                    end
+                end
+
+                SPI_READ: begin
+                    if (!spi_setup) begin
+                        // Next byte once the last one was taken
+                        if (rd_cnt != 0 || !rx_valid) begin
+                            spi_sck   <= 0; // flash shifts out a bit
+                            spi_setup <= 1;
+                            if (rd_cnt == 0) rd_cnt <= 8;
+                        end
+                    end else begin
+                        spi_sck   <= 1;
+                        spi_setup <= 0;
+                        spi_rx    <= {spi_rx[6:0], spi_miso};
+                        rd_cnt    <= rd_cnt - 1;
+                        if (rd_cnt == 1) begin
+                            rx_byte  <= {spi_rx[6:0], spi_miso};
+                            rx_valid <= 1;
+                        end
+                    end
+                end
+
+                default: ;
+            endcase
+
+            case (state)
+                B_HEADER: begin
+                    if (rx_valid) begin
+                        rx_valid <= 0;
+                        hdr      <= full;
+                        hdr_cnt  <= hdr_cnt + 1;
+                        if (hdr_cnt == 7) begin
+                            if (full[47:24] == 0 || full[63:56] != 0) begin
+                                state <= B_DONE;
+                            end else begin
+                                out_addr <= full[19:0];
+                                out_left <= full[47:24];
+                                have_lo  <= 0;
+                                state    <= full[48] ? B_FLAGS : B_RAW;
+                            end
+                        end
+                    end
+                end
+
+                B_RAW: begin
+                    if (rx_valid) begin
+                        rx_valid  <= 0;
+                        emit      = 1;
+                        emit_byte = rx_byte;
+                    end
+                end
+
+                B_FLAGS: begin
+                    if (rx_valid) begin
+                        rx_valid <= 0;
+                        flags    <= rx_byte;
+                        flag_cnt <= 8;
+                        state    <= B_ITEM;
+                    end
+                end
+
+                B_ITEM: begin
+                    if (flag_cnt == 0) begin
+                        state <= B_FLAGS;
+                    end else if (rx_valid) begin
+                        rx_valid <= 0;
+                        flags    <= flags >> 1;
+                        flag_cnt <= flag_cnt - 1;
+                        if (flags[0]) begin
+                            emit      = 1;
+                            emit_byte = rx_byte;
+                        end else begin
+                            m_lo  <= rx_byte;
+                            state <= B_MATCH;
+                        end
+                    end
+                end
+
+                B_MATCH: begin
+                    if (rx_valid) begin
+                        rx_valid <= 0;
+                        m_src    <= wpos - {rx_byte[7:4], m_lo} - 12'd1;
+                        m_len    <= 5'(rx_byte[3:0]) + 5'd3;
+                        state    <= B_COPY;
+                    end
+                end
+
+                // One byte per cycle; the last one written is already in
+                // the window, so overlapping matches repeat it
+                B_COPY: begin
+                    emit      = 1;
+                    emit_byte = window[m_src];
+                    m_src    <= m_src + 1;
+                    m_len    <= m_len - 1;
+                    cont      = m_len == 1 ? B_ITEM : B_COPY;
+                end
+
+                B_WRITE: begin
+                    if (wr_ack) begin
+                        wr_valid <= 0;
+                        state    <= ret_state;
+                    end
+                end
+
+                B_DONE: begin
+                    active    <= 0;
+                    spi_phase <= SPI_OFF;
+                    spi_cs_n  <= 1;
+                    spi_sck   <= 0;
+                end
+
+                default: state <= B_DONE;
+            endcase
+
+            // Every output byte goes into the window; pairs go out as words
+            if (emit) begin
+                window[wpos] <= emit_byte;
+                wpos         <= wpos + 1;
+                out_left     <= out_left - 1;
+                if (out_left == 1) cont = B_HEADER;
+                if (have_lo) begin
+                    wr_addr   <= out_addr;
+                    wr_data   <= {emit_byte, lo_byte};
+                    wr_valid  <= 1;
+                    out_addr  <= out_addr + 2;
+                    have_lo   <= 0;
+                    ret_state <= cont;
+                    state     <= B_WRITE;
+                end else begin
+                    lo_byte <= emit_byte;
+                    have_lo <= 1;
+                    state   <= cont;
+                end
+            end
+        end
+    end
+
+endmodule
@@ -0,0 +1,141 @@
+#include "cycle_profile.h"
+#include "ppu_regs.h"
+#include "vram_init_data.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+
+namespace cycle_profile {
+
+using vram_init::Layout;
+
+void SymbolTable::add(uint32_t addr, const std::string& name) {
+    auto it = std::lower_bound(symbols.begin(), symbols.end(), addr,
+                               [](const std::pair<uint32_t, std::string>& s, uint32_t a) { return s.first < a; });
+    if (it != symbols.end() && it->first == addr) {
+        it->second = name;
+    } else {
+        symbols.insert(it, {addr, name});
+    }
+}
+
+bool SymbolTable::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string addr, a, b;
+        if (!(fields >> addr) || addr[0] == '#' || !(fields >> a)) continue;
+        const std::string& name = (fields >> b) ? b : a;
+
+        char*               end   = nullptr;
+        const unsigned long value = std::strtoul(addr.c_str(), &end, 16);
+        if (*end != '\0') continue;
+        add(static_cast<uint32_t>(value), name);
+    }
+    return true;
+}
+
+const std::string& SymbolTable::lookup(uint32_t addr) const {
+    auto it = std::upper_bound(symbols.begin(), symbols.end(), addr,
+                               [](uint32_t a, const std::pair<uint32_t, std::string>& s) { return a < s.first; });
+    return it == symbols.begin() ? unknown : std::prev(it)->second;
+}
+
+uint32_t SymbolTable::address_of(uint32_t addr) const {
+    auto it = std::upper_bound(symbols.begin(), symbols.end(), addr,
+                               [](uint32_t a, const std::pair<uint32_t, std::string>& s) { return a < s.first; });
+    return it == symbols.begin() ? 0 : std::prev(it)->first;
+}
+
+SymbolTable default_symbols(const uint8_t* ram, std::size_t ram_size) {
+    const ppu_regs::Regs regs = ppu_regs::Regs::from_ram(ram, ram_size);
+
+    SymbolTable t;
+    t.add(regs.palette_base(), "palettes");
+    t.add(regs.tile_base(), "tiles");
+    t.add(regs.bg_map_base(), "bg_map");
+    t.add(regs.ui_map_base(), "ui_map");
+    t.add(regs.oam_base(), "oam");
+    t.add(Layout::reg_base, "regs");
+    t.add(Layout::remap_base, "remap");
+    t.add(Layout::anim_base, "anim");
+    if (regs.world_map()) {
+        t.add(static_cast<uint32_t>(regs.word[ppu_regs::WORLD_HI] & 0xF) << 16 | regs.word[ppu_regs::WORLD_LO],
+              "world_map");
+    }
+    return t;
+}
+
+void Profiler::finish() {
+    if (pending) {
+        by_addr[last_addr] += pending;
+        pending = 0;
+    }
+}
+
+// Flame graph tools split frames on ';' and the count on the last space
+static std::string frame_name(const std::string& name) {
+    std::string s = name;
+    for (char& c : s) {
+        if (c == ';' || c == ' ') c = '_';
+    }
+    return s;
+}
+
+std::vector<std::pair<std::string, uint64_t>> Profiler::by_symbol(const SymbolTable& symbols) const {
+    std::map<std::string, uint64_t> sums;
+    for (const auto& a : by_addr) sums[symbols.lookup(a.first)] += a.second;
+    if (pending) sums[symbols.lookup(last_addr)] += pending;
+
+    std::vector<std::pair<std::string, uint64_t>> v(sums.begin(), sums.end());
+    std::stable_sort(v.begin(), v.end(), [](const auto& x, const auto& y) { return x.second > y.second; });
+    return v;
+}
+
+void Profiler::write_folded(FILE* out, const SymbolTable& symbols) const {
+    if (cpu_run) std::fprintf(out, "cpu;run %llu\n", static_cast<unsigned long long>(cpu_run));
+    if (cpu_request) std::fprintf(out, "cpu;stall;bus_request %llu\n", static_cast<unsigned long long>(cpu_request));
+    for (const auto& s : by_symbol(symbols)) {
+        std::fprintf(out, "cpu;stall;ppu_fetch;%s %llu\n", frame_name(s.first).c_str(),
+                     static_cast<unsigned long long>(s.second));
+    }
+}
+
+void Profiler::print(FILE* out, const SymbolTable& symbols, int top) const {
+    const double cpu_per_cycle = cpu_clock_hz / ppu_clock_hz;
+    auto line = [&](const char* what, uint64_t n) {
+        std::fprintf(out, "  %-24s %12llu cycles  %12.0f CPU clocks  %5.1f%%\n", what,
+                     static_cast<unsigned long long>(n), n * cpu_per_cycle, cycles ? 100.0 * n / cycles : 0.0);
+    };
+
+    std::fprintf(out, "bus time (%llu PPU cycles at %.1f MHz, CPU at %.1f MHz)\n",
+                 static_cast<unsigned long long>(cycles), ppu_clock_hz / 1e6, cpu_clock_hz / 1e6);
+    line("cpu owns the bus", cpu_run);
+    line("stall: bus request", cpu_request);
+    line("stall: ppu fetch", cpu_fetch);
+
+    std::fprintf(out, "ppu fetch by symbol\n");
+    for (const auto& s : by_symbol(symbols)) line(s.first.c_str(), s.second);
+
+    std::vector<std::pair<uint32_t, uint64_t>> addrs(by_addr.begin(), by_addr.end());
+    std::sort(addrs.begin(), addrs.end(),
+              [](const auto& x, const auto& y) { return x.second != y.second ? x.second > y.second : x.first < y.first; });
+    if (static_cast<int>(addrs.size()) > top) addrs.resize(static_cast<std::size_t>(std::max(top, 0)));
+
+    std::fprintf(out, "busiest addresses\n");
+    for (const auto& a : addrs) {
+        char what[64];
+        std::snprintf(what, sizeof(what), "%05x %s+0x%x", a.first, symbols.lookup(a.first).c_str(),
+                      a.first - symbols.address_of(a.first));
+        line(what, a.second);
+    }
+}
+
+} // namespace cycle_profile
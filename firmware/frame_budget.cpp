@@ -0,0 +1,137 @@
+#include "frame_budget.h"
+#include "vram_init_data.h"
+#include "ppu_regs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace frame_budget {
+
+using vram_init::Layout;
+using vram_init::Params;
+
+// What one refresh copies, in bytes (ppu.sv's internal arrays)
+static constexpr uint32_t palette_read = Params::palette_count * Params::colors_per_palette * Params::bytes_per_color;
+static constexpr uint32_t tile_read    = 512 * Params::bytes_per_tile;
+static constexpr uint32_t bg_map_read  = Params::bg_map_w_tiles * Params::bg_map_h_tiles;
+static constexpr uint32_t ui_map_read  = Params::ui_map_w_tiles * Params::ui_map_h_tiles;
+static constexpr uint32_t reg_read     = ppu_regs::word_count * 2;
+
+static_assert(palette_read <= Layout::palette_bytes, "palette refresh overruns its Layout region");
+static_assert(tile_read <= Layout::tile_bytes, "tile refresh overruns its Layout region");
+static_assert(tile_read == Layout::tile_read_bytes, "VramFingerprint tracks a different tile span");
+static_assert(bg_map_read <= Layout::bg_map_bytes, "BG map refresh overruns its Layout region");
+static_assert(ui_map_read <= Layout::ui_map_bytes, "UI map refresh overruns its Layout region");
+static_assert(reg_read <= Layout::reg_bytes, "register refresh overruns its Layout region");
+static_assert(ppu_regs::remap_entries <= Layout::remap_bytes, "remap refresh overruns its Layout region");
+
+bool Config::apply(const std::string& params) {
+    std::size_t pos = 0;
+    while (pos < params.size()) {
+        std::size_t end = params.find(',', pos);
+        if (end == std::string::npos) end = params.size();
+        const std::string item = params.substr(pos, end - pos);
+        pos = end + 1;
+        if (item.empty()) continue;
+
+        const std::size_t eq = item.find('=');
+        if (eq == std::string::npos) return false;
+        const std::string name  = item.substr(0, eq);
+        char*             rest  = nullptr;
+        const long        value = std::strtol(item.c_str() + eq + 1, &rest, 0);
+        if (*rest != '\0') return false;
+
+        if (name == "DISP_WIDTH") {
+            width = static_cast<int>(value);
+        } else if (name == "DISP_HEIGHT") {
+            height = static_cast<int>(value);
+        } else if (name == "MAX_OBJECTS") {
+            max_objects = static_cast<int>(value);
+        } else if (name == "BUS_READ_LATENCY") {
+            bus_read_latency = static_cast<int>(value);
+        } else if (name == "MEM_WIDTH") {
+            mem_width = static_cast<int>(value);
+        }
+    }
+    return true;
+}
+
+Estimate estimate(const Config& c) {
+    Estimate e;
+
+    // READ_WAIT always takes at least one cycle
+    const uint64_t latency = static_cast<uint64_t>(std::max(1, c.bus_read_latency));
+    const uint64_t objects = static_cast<uint64_t>(c.max_objects);
+
+    const uint64_t width    = c.mem_width == 32 ? 4 : 2; // bytes per read
+
+    // World map mode reads the window one cell (byte) per bus read instead
+    // of the 64x64 map two or four cells per read
+    const uint64_t bg_reads = c.world_map ? static_cast<uint64_t>(ppu_regs::window_w(c.width)) * ppu_regs::window_h(c.height)
+                                          : bg_map_read / width;
+    const uint64_t remap    = c.tile_remap ? ppu_regs::remap_entries : 0;
+    const uint64_t anim     = c.sprite_anim ? objects : 0;
+    const uint64_t words    = (reg_read + remap + palette_read + tile_read + ui_map_read + anim) / width + bg_reads;
+
+    // Issue (refresh FSM) -> READ_REQ -> READ_WAIT x latency -> op_done seen
+    // -> back to the issuing state; on the 16-bit path OAM issues the high
+    // read straight from the low word's wait state
+    if (width == 4) {
+        e.reads       = words + objects;
+        e.read_cycles = (words + objects) * (4 + latency);
+    } else {
+        e.reads       = words + 2 * objects;
+        e.read_cycles = words * (4 + latency) + objects * (7 + 2 * latency);
+    }
+
+    // BGACK goes low two cycles after the grant (AS high check, SEIZE_BUS)
+    // and comes back in RELEASE_BUS two cycles after DONE
+    e.refresh_hold = e.read_cycles + 3;
+
+    // want_bus -> BR: 1, BR -> BG: grant_delay, BG -> first read: 4,
+    // DONE -> pixel: 1. A refresh restarted by the mem_refreshed pulse
+    // waits one more cycle for RELEASE_BUS.
+    const uint64_t grant = static_cast<uint64_t>(std::max(0, c.grant_delay));
+    e.refresh_period = e.read_cycles + grant + 6;
+
+    e.render_cycles = static_cast<uint64_t>(c.width) * static_cast<uint64_t>(c.height);
+    if (e.refresh_period <= e.render_cycles) {
+        e.refreshes    = 2;
+        e.stall_cycles = e.refresh_period;
+        e.frame_cycles = e.render_cycles + e.stall_cycles;
+    } else {
+        // The overlapped refresh is still running at (0,0) and sets the pace
+        e.refreshes    = 1;
+        e.stall_cycles = e.refresh_period - e.render_cycles;
+        e.frame_cycles = e.refresh_period;
+    }
+    e.bus_hold_cycles = e.refresh_hold * static_cast<uint64_t>(e.refreshes);
+
+    e.cpu_share     = 1.0 - double(e.bus_hold_cycles) / double(e.frame_cycles);
+    e.fps           = c.clock_hz / double(e.frame_cycles);
+    e.budget_cycles = c.budget_cycles();
+    e.fits          = e.frame_cycles <= e.budget_cycles;
+    return e;
+}
+
+double drift(double estimated, double simulated) {
+    if (simulated == 0.0) return estimated == 0.0 ? 0.0 : 1.0;
+    return std::fabs(simulated - estimated) / simulated;
+}
+
+void Estimate::print(FILE* out) const {
+    std::fprintf(out, "refresh      %llu reads, %llu cycles, %llu hold, %d per frame\n",
+                 static_cast<unsigned long long>(reads), static_cast<unsigned long long>(read_cycles),
+                 static_cast<unsigned long long>(refresh_hold), refreshes);
+    std::fprintf(out, "frame        %llu cycles = %llu render + %llu stalled at (0,0)\n",
+                 static_cast<unsigned long long>(frame_cycles), static_cast<unsigned long long>(render_cycles),
+                 static_cast<unsigned long long>(stall_cycles));
+    std::fprintf(out, "bus hold     %llu cycles/frame, CPU owns the bus %.1f%% of the time\n",
+                 static_cast<unsigned long long>(bus_hold_cycles), 100.0 * cpu_share);
+    std::fprintf(out, "budget       %llu cycles/frame: %s (%.1f fps, %+.1f%% headroom)\n",
+                 static_cast<unsigned long long>(budget_cycles), fits ? "fits" : "OVER", fps,
+                 100.0 * (double(budget_cycles) - double(frame_cycles)) / double(budget_cycles));
+}
+
+} // namespace frame_budget
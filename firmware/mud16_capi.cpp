@@ -0,0 +1,85 @@
+#include "mud16.h"
+#include "mud16_system.h"
+
+// The opaque handle is the C++ system itself
+struct mud16_system {
+    Mud16System impl;
+};
+
+extern "C" {
+
+int mud16_api_version(void) {
+    return MUD16_API_VERSION;
+}
+
+mud16_system* mud16_create(void) {
+    // Nothing may throw across the C boundary: the RAM vector, the Verilated
+    // model and the first ticks can all fail
+    mud16_system* sys = nullptr;
+    try {
+        sys = new mud16_system;
+        // Out of reset, so stepping frames right away makes progress
+        sys->impl.reset();
+        return sys;
+    } catch (...) {
+        delete sys;
+        return nullptr;
+    }
+}
+
+void mud16_destroy(mud16_system* sys) {
+    delete sys;
+}
+
+void mud16_reset(mud16_system* sys) {
+    if (!sys) return;
+    sys->impl.reset();
+}
+
+int mud16_load_image(mud16_system* sys, const uint8_t* data, size_t size, uint32_t offset) {
+    if (!sys) return -1;
+    return sys->impl.load_image(data, size, offset) ? 0 : -1;
+}
+
+void mud16_step_cycles(mud16_system* sys, uint64_t cycles) {
+    if (!sys) return;
+    sys->impl.step_cycles(cycles);
+}
+
+void mud16_step_frames(mud16_system* sys, uint32_t frames) {
+    if (!sys) return;
+    sys->impl.step_frames(frames);
+}
+
+const uint8_t* mud16_framebuffer(const mud16_system* sys, int* width, int* height) {
+    if (width)  *width  = Mud16System::width;
+    if (height) *height = Mud16System::height;
+    if (!sys) return nullptr;
+    return sys->impl.framebuffer();
+}
+
+size_t mud16_ram_size(const mud16_system* sys) {
+    if (!sys) return 0;
+    return sys->impl.ram.size();
+}
+
+int mud16_read_ram(const mud16_system* sys, uint32_t addr, uint8_t* dst, size_t len) {
+    if (!sys) return -1;
+    return sys->impl.read_ram(addr, dst, len) ? 0 : -1;
+}
+
+int mud16_write_ram(mud16_system* sys, uint32_t addr, const uint8_t* src, size_t len) {
+    if (!sys) return -1;
+    return sys->impl.write_ram(addr, src, len) ? 0 : -1;
+}
+
+void mud16_get_stats(const mud16_system* sys, mud16_stats* out) {
+    if (!sys || !out) return;
+    Mud16Stats s = sys->impl.stats();
+    out->cycles          = s.cycles;
+    out->frames          = s.frames;
+    out->pixels          = s.pixels;
+    out->bus_hold_cycles = s.bus_hold_cycles;
+}
+
+} // extern "C"
@@ -0,0 +1,9 @@
+#include "mud16_system.h"
+
+#ifdef MUD16_CLK_PREV
+#include "Vppu___024root.h"
+#endif
+
+#include "mud16_system_impl.h"
+
+template class BasicMud16System<Vppu>;
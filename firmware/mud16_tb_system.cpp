@@ -0,0 +1,114 @@
+#include "mud16_tb_system.h"
+#include "vram_init_data.h"
+
+#include "Vtb_top___024root.h"
+
+Mud16TbSystem::Mud16TbSystem()
+    : context(new VerilatedContext) {
+    top = new Vtb_top{context.get()};
+
+    std::vector<uint8_t> ram(ram_size, 0);
+    vram_init::load(ram);
+    load_image(ram.data(), ram.size());
+
+    fb_rgba.assign(static_cast<std::size_t>(width) * height * 4, 0);
+
+    top->clk = 0;
+    top->reset = 1;
+    top->boot_flash = 0;
+    top->eval();
+}
+
+Mud16TbSystem::~Mud16TbSystem() {
+    top->final();
+    delete top;
+}
+
+void Mud16TbSystem::tick() {
+    top->clk = 1;
+#ifdef MUD16_TB_CLK_PREV
+    // Nothing changed since the last rising eval but clk, which Verilator
+    // still remembers as high
+    top->rootp->MUD16_TB_CLK_PREV = 0;
+    top->eval();
+    top->clk = 0;
+#else
+    top->eval();
+    top->clk = 0;
+    top->eval();
+#endif
+    tick_count++;
+}
+
+void Mud16TbSystem::reset() {
+    top->reset = 1;
+    tick();
+    tick();
+    top->reset = 0;
+}
+
+void Mud16TbSystem::step_cycles(uint64_t cycles) {
+    for (uint64_t i = 0; i < cycles; i++) {
+        tick();
+    }
+}
+
+void Mud16TbSystem::step_frames(uint32_t frames) {
+    const uint32_t target = top->frame_count + frames;
+    while (top->frame_count != target) {
+        tick();
+    }
+}
+
+const uint8_t* Mud16TbSystem::framebuffer() const {
+    const auto& fb = top->rootp->tb_top__DOT__fb;
+    for (int i = 0; i < width * height; i++) {
+        uint32_t rgb = fb[i];
+        fb_rgba[i * 4 + 0] = static_cast<uint8_t>(rgb >> 16);
+        fb_rgba[i * 4 + 1] = static_cast<uint8_t>(rgb >> 8);
+        fb_rgba[i * 4 + 2] = static_cast<uint8_t>(rgb);
+        fb_rgba[i * 4 + 3] = 255;
+    }
+    return fb_rgba.data();
+}
+
+bool Mud16TbSystem::load_image(const uint8_t* data, std::size_t size, uint32_t offset) {
+    return write_ram(offset, data, size);
+}
+
+bool Mud16TbSystem::load_flash(const uint8_t* data, std::size_t size) {
+    if (!data || size > SpiFlash::capacity) return false;
+    auto& flash = top->rootp->tb_top__DOT__flash;
+    for (std::size_t i = 0; i < SpiFlash::capacity; i++) flash[i] = i < size ? data[i] : 0xFF;
+    top->boot_flash = 1;
+    return true;
+}
+
+bool Mud16TbSystem::read_ram(uint32_t addr, uint8_t* dst, std::size_t len) const {
+    if (!dst || addr > static_cast<uint32_t>(ram_size) || len > ram_size - addr) return false;
+    const auto& sram = top->rootp->tb_top__DOT__sram;
+    for (std::size_t i = 0; i < len; i++) dst[i] = sram[addr + i];
+    return true;
+}
+
+bool Mud16TbSystem::write_ram(uint32_t addr, const uint8_t* src, std::size_t len) {
+    if (!src || addr > static_cast<uint32_t>(ram_size) || len > ram_size - addr) return false;
+    auto& sram = top->rootp->tb_top__DOT__sram;
+    for (std::size_t i = 0; i < len; i++) sram[addr + i] = src[i];
+    return true;
+}
+
+Mud16Stats Mud16TbSystem::stats() const {
+    Mud16Stats s;
+    s.cycles          = tick_count ? tick_count - 1 : 0; // see the class comment
+    s.frames          = top->frame_count;
+    s.pixels          = top->pixel_count;
+    s.bus_hold_cycles = top->bus_hold_cycles;
+    s.held_frames          = top->held_frames;
+    s.held_bus_hold_cycles = top->held_bus_hold_cycles;
+    s.panel_refreshes      = top->panel_refreshes;
+    s.tear_events          = top->tear_events;
+    s.boot_cycles          = top->boot_cycles;
+    s.flash_bytes_read     = top->flash_bytes_read;
+    return s;
+}
@@ -0,0 +1,119 @@
+#include "png_writer.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace png_writer {
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+struct CrcTable {
+    uint32_t v[256];
+
+    CrcTable() {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            v[n] = c;
+        }
+    }
+};
+
+// Function-local static so concurrent writers initialise it safely
+static const CrcTable& crc_table() {
+    static const CrcTable table;
+    return table;
+}
+
+static uint32_t crc32(const uint8_t* data, std::size_t len, uint32_t crc = 0) {
+    const CrcTable& table = crc_table();
+    crc = ~crc;
+    for (std::size_t i = 0; i < len; ++i) {
+        crc = table.v[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+static void put32be(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v >> 24));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+static void put_chunk(std::vector<uint8_t>& out, const char type[4], const std::vector<uint8_t>& data) {
+    put32be(out, static_cast<uint32_t>(data.size()));
+    std::size_t type_pos = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    put32be(out, crc32(out.data() + type_pos, data.size() + 4));
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+
+bool write_rgba(const std::string& path, int width, int height, const uint8_t* rgba) {
+    if (!rgba || width <= 0 || height <= 0) return false;
+
+    // Raw scanlines, each prefixed with filter type 0
+    const std::size_t stride = static_cast<std::size_t>(width) * 4;
+    std::vector<uint8_t> raw;
+    raw.reserve((stride + 1) * height);
+    for (int y = 0; y < height; ++y) {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgba + y * stride, rgba + (y + 1) * stride);
+    }
+
+    // zlib stream made of stored deflate blocks
+    std::vector<uint8_t> z;
+    z.push_back(0x78);
+    z.push_back(0x01);
+    std::size_t pos = 0;
+    do {
+        std::size_t len = raw.size() - pos;
+        if (len > 65535) len = 65535;
+        bool last = (pos + len == raw.size());
+        z.push_back(last ? 1 : 0);
+        z.push_back(static_cast<uint8_t>(len & 0xFF));
+        z.push_back(static_cast<uint8_t>(len >> 8));
+        z.push_back(static_cast<uint8_t>(~len & 0xFF));
+        z.push_back(static_cast<uint8_t>((~len >> 8) & 0xFF));
+        z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + len);
+        pos += len;
+    } while (pos < raw.size());
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    put32be(z, (b << 16) | a);
+
+    std::vector<uint8_t> ihdr;
+    put32be(ihdr, static_cast<uint32_t>(width));
+    put32be(ihdr, static_cast<uint32_t>(height));
+    ihdr.push_back(8); // bit depth
+    ihdr.push_back(6); // colour type RGBA
+    ihdr.push_back(0); // compression
+    ihdr.push_back(0); // filter
+    ihdr.push_back(0); // interlace
+
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    std::vector<uint8_t> out(signature, signature + 8);
+    put_chunk(out, "IHDR", ihdr);
+    put_chunk(out, "IDAT", z);
+    put_chunk(out, "IEND", std::vector<uint8_t>());
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+    ok = (std::fclose(f) == 0) && ok;
+    return ok;
+}
+
+} // namespace png_writer
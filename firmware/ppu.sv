@@ -11,19 +11,41 @@ module ppu #(
     parameter BG_MAP_MEM_OFFSET  = 18'h05000,
     parameter UI_MAP_MEM_OFFSET  = 18'h06000,
     parameter OAM_MEM_OFFSET     = 18'h07000,
+    parameter REG_MEM_OFFSET     = 18'h07400,
+    parameter REMAP_MEM_OFFSET   = 18'h07800,
+    parameter ANIM_MEM_OFFSET    = 18'h07C00,
 
     // Memory timing
-    parameter BUS_READ_LATENCY = 1
+    parameter BUS_READ_LATENCY = 1,
+
+    // Memory path width: 16 reads one SRAM chip per bus cycle, 32 reads both
+    // chips at once (the upper half of mem_rdata) and halves the refresh.
+    // 32 bit reads are 4-byte aligned, one address for both chips
+    parameter MEM_WIDTH = 16
 
 ) (
     input  logic clk,
     input  logic reset,
 
+    // Tearing effect output of the display (ILI9488 TE, V-blank mode)
+    input  logic te,
+
+    // Boot from SPI flash (boot_loader.sv): strap sampled during reset, and
+    // high while the image is streamed into SRAM
+    input  logic boot_flash,
+    output logic booting,
+    output logic spi_cs_n,
+    output logic spi_sck,
+    output logic spi_mosi,
+    input  logic spi_miso,
+
     // Pixel outputs (VGA interface)
     output logic [7:0] pixel_r,
     output logic [7:0] pixel_g,
     output logic [7:0] pixel_b,
     output logic       pixel_sync,
+    output logic       vblank,       // one cycle after the last pixel position of every frame, held or not
+    output logic       te_idle,      // only waiting for TE, which was low: nothing changes until it rises
 
     // 68000 Bus Arbitration Signals
     input  logic       cpu_bg_n,      // Bus Grant (Active Low) from CPU
@@ -36,7 +58,7 @@ module ppu #(
 
     // Memory interface (Shared Bus)
     output logic [19:0] mem_addr,
-    input  logic [15:0] mem_rdata,
+    input  logic [MEM_WIDTH-1:0] mem_rdata,
     output logic [15:0] mem_wdata,
     output logic        mem_read,
     output logic        mem_write
@@ -57,9 +79,13 @@ module ppu #(
         RELEASE_BUS
     } bus_state_t;
 
+    // Bytes and 16-bit words per refresh read
+    localparam RD_BYTES = MEM_WIDTH / 8;
+    localparam RD_WORDS = MEM_WIDTH / 16;
+
     bus_state_t bus_state;
     reg  [7:0]  bus_wait_cnt;
-    reg  [15:0] bus_rdata_latched;
+    reg  [31:0] bus_rdata_latched;
     reg  [15:0] bus_wdata_latched;
     reg  [19:0] bus_addr_latched;
     reg         bus_op_done;
@@ -72,6 +98,27 @@ module ppu #(
     logic need_mem_refresh;
     logic mem_refreshed;
 
+    // Boot loader, served by the refresh FSM until it is done
+    logic        boot_wr_valid;
+    logic [19:0] boot_wr_addr;
+    logic [15:0] boot_wr_data;
+    logic        boot_wr_ack;
+
+    boot_loader u_boot (
+        .clk(clk),
+        .reset(reset),
+        .boot(boot_flash),
+        .active(booting),
+        .spi_cs_n(spi_cs_n),
+        .spi_sck(spi_sck),
+        .spi_mosi(spi_mosi),
+        .spi_miso(spi_miso),
+        .wr_valid(boot_wr_valid),
+        .wr_addr(boot_wr_addr),
+        .wr_data(boot_wr_data),
+        .wr_ack(boot_wr_ack)
+    );
+
     // Memory arrays
     reg [11:0] palette [0:7][0:15];      // 8 palettes, 16 colors each, 12-bit RGB
     reg [7:0]  tile_memory [0:16383];    // 512 tiles * 32 bytes = 16KB
@@ -84,20 +131,159 @@ module ppu #(
     reg [2:0]  ui_top_palette;           // UI palette index (top)
     reg [2:0]  ui_bottom_palette;        // UI palette index (bottom)
 
+    // PPU registers (16-bit words at REG_MEM_OFFSET, read before the palettes)
+    //   0: control, bit 0 = world map mode, bit 1 = tile remap,
+    //      bit 2 = sprite animation, bit 3 = colour cycling,
+    //      bit 4 = present on demand, bit 5 = TE sync
+    //   1: scroll x in pixels (world map mode)
+    //   2: scroll y in pixels (world map mode)
+    //   3: world map width in tiles
+    //   4: world map height in tiles
+    //   5: world map byte address [15:0]
+    //   6: world map byte address [19:16]
+    //   7: present counter (present-on-demand mode)
+    //   8, 9: colour cycle ranges, [2:0] palette, [6:3] first index,
+    //         [10:7] length - 1 (0 = off), [15:11] vblanks per step - 1
+    //  10-14: palette, tile, BG map, UI map and OAM base, byte address / 16
+    //         (0 = the *_MEM_OFFSET parameter)
+    localparam REG_WORDS = 16;
+    reg [15:0] ppu_regs [0:REG_WORDS-1];
+
+    // Relocatable bases: latched from registers 10-14 only by the refresh
+    // that starts at vblank, so the second refresh of a frame reads the same
+    // buffers as the first. A game builds the next OAM or map elsewhere and
+    // flips the pointer; the flip shows from the next frame on.
+    localparam BASE_PALETTE = 0;
+    localparam BASE_TILE    = 1;
+    localparam BASE_BG_MAP  = 2;
+    localparam BASE_UI_MAP  = 3;
+    localparam BASE_OAM     = 4;
+    localparam BASE_REG     = 10;
+    localparam logic [19:0] BASE_DEFAULT [0:4] = '{
+        20'(PALETTE_MEM_OFFSET), 20'(TILE_MEM_OFFSET), 20'(BG_MAP_MEM_OFFSET),
+        20'(UI_MAP_MEM_OFFSET), 20'(OAM_MEM_OFFSET)
+    };
+    reg [19:0] mem_base [0:4];
+    reg        vblank_refresh;
+
+    // Present on demand: the CPU changes register 7 when a new frame is
+    // ready. If it hasn't changed since the last presented frame, the
+    // vblank refresh stops after the registers, nothing is rendered or sent
+    // to the display and the panel keeps showing its GRAM.
+    logic      present_on;
+    reg [15:0] present_seen;
+    reg        frame_held;
+
+    // TE sync: after the refresh at (0,0) the first pixel waits for the
+    // display's TE to rise, i.e. for its scan to enter vertical blanking.
+    // The PPU writes lines faster than the panel scans them, so GRAM writes
+    // that start there stay ahead of the scan for the whole frame.
+    logic      te_sync_on;
+    reg  [2:0] te_sync;     // synchronizer, [2] is the previous sample
+    reg        wait_te;
+    reg        te_go;       // TE seen, draw (0,0)
+
+    // World map mode: instead of copying the 64x64 map, the refresh fetches
+    // the window of the world map under the scroll position into
+    // bg_tile_map, one extra row and column for the fine scroll
+    localparam WIN_W = DISP_WIDTH / 8 + 1;
+    localparam WIN_H = DISP_HEIGHT / 8 + 1;
+
+    logic        world_mode;
+    logic [2:0]  bg_fine_x;
+    logic [2:0]  bg_fine_y;
+    reg   [5:0]  win_x;
+    reg   [5:0]  win_y;
+    reg    [1:0] win_byte;
+    reg          win_inside;
+    logic [15:0] world_col;
+    logic [15:0] world_row;
+    logic [19:0] world_addr;
+
+    // Tile remap: BG and UI tile indices go through this table before the
+    // tile_memory lookup, so animating every instance of a tile is one byte
+    // written to the table in SRAM. Only fetched while enabled.
+    reg [7:0] tile_remap [0:255];
+    logic     remap_on;
+
+    // Sprite animation: one descriptor byte per OAM entry at
+    // ANIM_MEM_OFFSET, [2:0] = frames - 1, [7:3] = vblanks per frame - 1.
+    // The object draws tile_idx + its current frame. The PPU advances the
+    // counters after the last pixel of every frame; a changed descriptor
+    // restarts the animation at frame 0. Only fetched while enabled.
+    reg [7:0] anim_desc  [0:MAX_OBJECTS-1];
+    reg [7:0] anim_seen  [0:MAX_OBJECTS-1]; // descriptor the counters belong to
+    reg [4:0] anim_step  [0:MAX_OBJECTS-1]; // vblanks into the current frame
+    reg [2:0] anim_frame [0:MAX_OBJECTS-1];
+    logic     anim_on;
+
+    // Colour cycling: within each range, colour index i of the palette is
+    // drawn with the entry (phase) places further on, wrapping inside the
+    // range. The PPU steps the phases at vblank, so the effect needs no
+    // palette writes; a changed range register takes effect at the next
+    // vblank, from phase 0.
+    localparam CYCLE_RANGES = 2;
+    reg [15:0] cycle_seen  [0:CYCLE_RANGES-1];
+    reg [4:0]  cycle_step  [0:CYCLE_RANGES-1];
+    reg [3:0]  cycle_phase [0:CYCLE_RANGES-1];
+    logic      cycle_on;
+
+    function automatic logic [3:0] cycle_index(input logic [2:0] pal, input logic [3:0] idx);
+        logic [15:0] cyc;
+        logic [3:0]  first;
+        logic [3:0]  span;  // length - 1
+        logic [4:0]  off;
+        cycle_index = idx;
+        for (int r = 0; r < CYCLE_RANGES; r++) begin
+            cyc   = cycle_seen[r];
+            first = cyc[6:3];
+            span  = cyc[10:7];
+            if (cycle_on && span != 0 && pal == cyc[2:0] && idx >= first && 5'(idx - first) <= 5'(span)) begin
+                off = 5'(idx - first) + 5'(cycle_phase[r]);
+                if (off > 5'(span)) off = off - 5'(span) - 5'd1;
+                cycle_index = first + off[3:0];
+            end
+        end
+    endfunction
+
+    always_comb begin
+        world_mode = ppu_regs[0][0];
+        remap_on   = ppu_regs[0][1];
+        anim_on    = ppu_regs[0][2];
+        cycle_on   = ppu_regs[0][3];
+        present_on = ppu_regs[0][4];
+        te_sync_on = ppu_regs[0][5];
+        bg_fine_x  = world_mode ? ppu_regs[1][2:0] : 3'd0;
+        bg_fine_y  = world_mode ? ppu_regs[2][2:0] : 3'd0;
+        world_col  = 16'(ppu_regs[1][15:3]) + 16'(win_x);
+        world_row  = 16'(ppu_regs[2][15:3]) + 16'(win_y);
+        world_addr = {ppu_regs[6][3:0], ppu_regs[5]} + 20'(world_row) * 20'(ppu_regs[3]) + 20'(world_col);
+    end
+
     // Memory Refresh FSM signals
-    typedef enum logic [3:0] {
+    typedef enum logic [4:0] {
         REFRESH_IDLE,
+        REFRESH_BOOT,
+        REFRESH_WAIT_BOOT,
+        REFRESH_REGS,
+        REFRESH_WAIT_REGS,
+        REFRESH_REMAP,
+        REFRESH_WAIT_REMAP,
         REFRESH_PALETTES,
         REFRESH_WAIT_PALETTE,
         REFRESH_TILES,
         REFRESH_WAIT_TILE,
         REFRESH_BG_MAP,
         REFRESH_WAIT_BG_MAP,
+        REFRESH_WORLD,
+        REFRESH_WAIT_WORLD,
         REFRESH_UI_MAP,
         REFRESH_WAIT_UI_MAP,
         REFRESH_OAM,
         REFRESH_WAIT_OAM_LOW,
         REFRESH_WAIT_OAM_HIGH,
+        REFRESH_ANIM,
+        REFRESH_WAIT_ANIM,
         REFRESH_DONE
     } refresh_state_t;
 
@@ -105,6 +291,8 @@ module ppu #(
     logic refresh_wait_mem;
     logic [3:0] refresh_palette;
 
+    assign boot_wr_ack = refresh_state == REFRESH_WAIT_BOOT && bus_op_done;
+
     // MEMORY FSM
 
     always_ff @(posedge clk) begin
@@ -173,7 +361,7 @@ module ppu #(
                     if (bus_wait_cnt < BUS_READ_LATENCY - 1) begin
                         bus_wait_cnt <= bus_wait_cnt + 1;
                     end else begin
-                        bus_rdata_latched <= mem_rdata;
+                        bus_rdata_latched <= 32'(mem_rdata);
                         if (!want_bus) begin
                             bus_state <= RELEASE_BUS;
                         end else begin
@@ -236,24 +424,140 @@ module ppu #(
             mem_refreshed     <= 0;
             refresh_cnt       <= 0;
             oam_temp_low      <= 0;
+            win_x             <= 0;
+            win_y             <= 0;
+            win_byte          <= 0;
+            win_inside        <= 0;
+            vblank_refresh    <= 0;
+            present_seen      <= 0;
+            frame_held        <= 0;
+            for (int b = 0; b < 5; b++) mem_base[b] <= BASE_DEFAULT[b];
         end else begin
             case (refresh_state)
                 REFRESH_IDLE: begin
                     mem_refreshed <= 0;
-                    if (need_mem_refresh) begin
+                    if (booting) begin
+                        // Boot first; the pixel counter waits at (0,0) for
+                        // the refresh that follows
+                        want_bus <= 1;
+                        refresh_state <= REFRESH_BOOT;
+                    end else if (need_mem_refresh) begin
+                        // The restart right after mem_refreshed is the
+                        // second refresh of the frame
+                        vblank_refresh <= !mem_refreshed;
                         want_bus <= 1;
-                        refresh_state <= REFRESH_PALETTES;
+                        refresh_state <= REFRESH_REGS;
+                        refresh_cnt <= 0;
                         palette_idx <= 0;
                         color_idx <= 0;
                     end
                 end
 
+                // -------------------------------------------------------------
+                // Boot image, one word per write for the boot loader. The
+                // bus stays with the PPU for the whole boot.
+                // -------------------------------------------------------------
+                REFRESH_BOOT: begin
+                    if (!booting) begin
+                        want_bus <= 0;
+                        refresh_state <= REFRESH_IDLE;
+                    end else if (boot_wr_valid && bus_state == BUS_MASTER && !bus_op_done) begin
+                        bus_addr_latched <= boot_wr_addr;
+                        bus_wdata_latched <= boot_wr_data;
+                        bus_req_write <= 1;
+                        refresh_state <= REFRESH_WAIT_BOOT;
+                    end
+                end
+
+                REFRESH_WAIT_BOOT: begin
+                    bus_req_write <= 0;
+                    if (bus_op_done) refresh_state <= REFRESH_BOOT;
+                end
+
+                // -------------------------------------------------------------
+                // Registers (REG_WORDS words)
+                // -------------------------------------------------------------
+                REFRESH_REGS: begin
+                    if (bus_state == BUS_MASTER && !bus_op_done) begin
+                        bus_addr_latched <= REG_MEM_OFFSET + 20'(refresh_cnt * RD_BYTES);
+                        bus_req_read <= 1;
+                        refresh_state <= REFRESH_WAIT_REGS;
+                    end
+                end
+
+                REFRESH_WAIT_REGS: begin
+                    bus_req_read <= 0;
+                    if (bus_op_done) begin
+                        for (int k = 0; k < RD_WORDS; k++) begin
+                            ppu_regs[4'(refresh_cnt * RD_WORDS + k)] <= bus_rdata_latched[16 * k +: 16];
+                        end
+
+                        if (refresh_cnt == REG_WORDS / RD_WORDS - 1) begin
+                            // The last read's words are still on their way
+                            // into ppu_regs
+                            if (vblank_refresh) begin
+                                for (int b = 0; b < 5; b++) begin
+                                    logic [15:0] w;
+                                    w = BASE_REG + b >= REG_WORDS - RD_WORDS
+                                      ? bus_rdata_latched[16 * ((BASE_REG + b) % RD_WORDS) +: 16]
+                                      : ppu_regs[BASE_REG + b];
+                                    mem_base[b] <= w != 0 ? {w, 4'b0} : BASE_DEFAULT[b];
+                                end
+                            end
+
+                            // Register 7 is in ppu_regs by now
+                            if (vblank_refresh) begin
+                                frame_held   <= present_on && ppu_regs[7] == present_seen;
+                                present_seen <= ppu_regs[7];
+                            end
+
+                            if (vblank_refresh ? present_on && ppu_regs[7] == present_seen : frame_held) begin
+                                refresh_state <= REFRESH_DONE;
+                            end else begin
+                                refresh_state <= remap_on ? REFRESH_REMAP : REFRESH_PALETTES;
+                            end
+                            refresh_cnt <= 0;
+                        end else begin
+                            refresh_cnt <= refresh_cnt + 1;
+                            refresh_state <= REFRESH_REGS;
+                        end
+                    end
+                end
+
+                // -------------------------------------------------------------
+                // Tile remap table (256 bytes), if enabled
+                // -------------------------------------------------------------
+                REFRESH_REMAP: begin
+                    if (bus_state == BUS_MASTER && !bus_op_done) begin
+                        bus_addr_latched <= REMAP_MEM_OFFSET + 20'(refresh_cnt * RD_BYTES);
+                        bus_req_read <= 1;
+                        refresh_state <= REFRESH_WAIT_REMAP;
+                    end
+                end
+
+                REFRESH_WAIT_REMAP: begin
+                    bus_req_read <= 0;
+                    if (bus_op_done) begin
+                        for (int k = 0; k < RD_BYTES; k++) begin
+                            tile_remap[8'(refresh_cnt * RD_BYTES + k)] <= bus_rdata_latched[8 * k +: 8];
+                        end
+
+                        if (refresh_cnt == 256 / RD_BYTES - 1) begin
+                            refresh_state <= REFRESH_PALETTES;
+                            refresh_cnt <= 0;
+                        end else begin
+                            refresh_cnt <= refresh_cnt + 1;
+                            refresh_state <= REFRESH_REMAP;
+                        end
+                    end
+                end
+
                 // -------------------------------------------------------------
                 // Palettes
                 // -------------------------------------------------------------
                 REFRESH_PALETTES: begin
                     if (bus_state == BUS_MASTER && !bus_op_done) begin
-                        bus_addr_latched <= PALETTE_MEM_OFFSET + 20'((palette_idx * 16 + color_idx) * 2);
+                        bus_addr_latched <= mem_base[BASE_PALETTE] + 20'((palette_idx * 16 + color_idx) * 2);
                         bus_req_read <= 1;
                         refresh_state <= REFRESH_WAIT_PALETTE;
                     end
@@ -262,9 +566,11 @@ module ppu #(
                 REFRESH_WAIT_PALETTE: begin
                     bus_req_read <= 0;
                     if (bus_op_done) begin
-                        palette[palette_idx][color_idx] <= bus_rdata_latched[11:0];
+                        for (int k = 0; k < RD_WORDS; k++) begin
+                            palette[palette_idx][color_idx + 4'(k)] <= bus_rdata_latched[16 * k +: 12];
+                        end
 
-                        if (color_idx == 15) begin
+                        if (color_idx == 4'(16 - RD_WORDS)) begin
                             color_idx <= 0;
                             if (palette_idx == 7) begin
                                 refresh_state <= REFRESH_TILES;
@@ -274,18 +580,18 @@ module ppu #(
                                 refresh_state <= REFRESH_PALETTES;
                             end
                         end else begin
-                            color_idx <= color_idx + 1;
+                            color_idx <= color_idx + 4'(RD_WORDS);
                             refresh_state <= REFRESH_PALETTES;
                         end
                     end
                 end
 
                 // -------------------------------------------------------------
-                // Tiles (16KB = 16384 bytes = 8192 words)
+                // Tiles (16KB = 16384 bytes)
                 // -------------------------------------------------------------
                 REFRESH_TILES: begin
                     if (bus_state == BUS_MASTER && !bus_op_done) begin
-                        bus_addr_latched <= TILE_MEM_OFFSET + 20'(refresh_cnt * 2);
+                        bus_addr_latched <= mem_base[BASE_TILE] + 20'(refresh_cnt * RD_BYTES);
                         bus_req_read <= 1;
                         refresh_state <= REFRESH_WAIT_TILE;
                     end
@@ -294,12 +600,15 @@ module ppu #(
                 REFRESH_WAIT_TILE: begin
                     bus_req_read <= 0;
                     if (bus_op_done) begin
-                        tile_memory[{refresh_cnt[12:0], 1'b0}] <= bus_rdata_latched[7:0];
-                        tile_memory[{refresh_cnt[12:0], 1'b1}] <= bus_rdata_latched[15:8];
+                        for (int k = 0; k < RD_BYTES; k++) begin
+                            tile_memory[14'(refresh_cnt * RD_BYTES + k)] <= bus_rdata_latched[8 * k +: 8];
+                        end
 
-                        if (refresh_cnt == 8191) begin
-                            refresh_state <= REFRESH_BG_MAP;
+                        if (refresh_cnt == 16384 / RD_BYTES - 1) begin
+                            refresh_state <= world_mode ? REFRESH_WORLD : REFRESH_BG_MAP;
                             refresh_cnt <= 0;
+                            win_x <= 0;
+                            win_y <= 0;
                         end else begin
                             refresh_cnt <= refresh_cnt + 1;
                             refresh_state <= REFRESH_TILES;
@@ -308,11 +617,11 @@ module ppu #(
                 end
 
                 // -------------------------------------------------------------
-                // BG Map (4096 bytes = 2048 words)
+                // BG Map (4096 bytes)
                 // -------------------------------------------------------------
                 REFRESH_BG_MAP: begin
                     if (bus_state == BUS_MASTER && !bus_op_done) begin
-                        bus_addr_latched <= BG_MAP_MEM_OFFSET + 20'(refresh_cnt * 2);
+                        bus_addr_latched <= mem_base[BASE_BG_MAP] + 20'(refresh_cnt * RD_BYTES);
                         bus_req_read <= 1;
                         refresh_state <= REFRESH_WAIT_BG_MAP;
                     end
@@ -321,10 +630,11 @@ module ppu #(
                 REFRESH_WAIT_BG_MAP: begin
                     bus_req_read <= 0;
                     if (bus_op_done) begin
-                        bg_tile_map[{refresh_cnt[10:0], 1'b0}] <= bus_rdata_latched[7:0];
-                        bg_tile_map[{refresh_cnt[10:0], 1'b1}] <= bus_rdata_latched[15:8];
+                        for (int k = 0; k < RD_BYTES; k++) begin
+                            bg_tile_map[12'(refresh_cnt * RD_BYTES + k)] <= bus_rdata_latched[8 * k +: 8];
+                        end
 
-                        if (refresh_cnt == 2047) begin
+                        if (refresh_cnt == 4096 / RD_BYTES - 1) begin
                             refresh_state <= REFRESH_UI_MAP;
                             refresh_cnt <= 0;
                         end else begin
@@ -335,11 +645,47 @@ module ppu #(
                 end
 
                 // -------------------------------------------------------------
-                // UI Map (400 bytes = 200 words)
+                // World map window (WIN_W x WIN_H bytes, one read each).
+                // Cells outside the world become tile 0.
+                // -------------------------------------------------------------
+                REFRESH_WORLD: begin
+                    if (bus_state == BUS_MASTER && !bus_op_done) begin
+                        bus_addr_latched <= world_addr & ~20'(RD_BYTES - 1);
+                        bus_req_read <= 1;
+                        win_byte <= 2'(world_addr & 20'(RD_BYTES - 1));
+                        win_inside <= world_col < ppu_regs[3] && world_row < ppu_regs[4];
+                        refresh_state <= REFRESH_WAIT_WORLD;
+                    end
+                end
+
+                REFRESH_WAIT_WORLD: begin
+                    bus_req_read <= 0;
+                    if (bus_op_done) begin
+                        bg_tile_map[{win_y, win_x}] <= !win_inside ? 8'd0
+                                                     : bus_rdata_latched[8 * win_byte +: 8];
+
+                        if (win_x == WIN_W - 1) begin
+                            win_x <= 0;
+                            if (win_y == WIN_H - 1) begin
+                                refresh_state <= REFRESH_UI_MAP;
+                                refresh_cnt <= 0;
+                            end else begin
+                                win_y <= win_y + 1;
+                                refresh_state <= REFRESH_WORLD;
+                            end
+                        end else begin
+                            win_x <= win_x + 1;
+                            refresh_state <= REFRESH_WORLD;
+                        end
+                    end
+                end
+
+                // -------------------------------------------------------------
+                // UI Map (400 bytes)
                 // -------------------------------------------------------------
                 REFRESH_UI_MAP: begin
                     if (bus_state == BUS_MASTER && !bus_op_done) begin
-                        bus_addr_latched <= UI_MAP_MEM_OFFSET + 20'(refresh_cnt * 2);
+                        bus_addr_latched <= mem_base[BASE_UI_MAP] + 20'(refresh_cnt * RD_BYTES);
                         bus_req_read <= 1;
                         refresh_state <= REFRESH_WAIT_UI_MAP;
                     end
@@ -348,10 +694,11 @@ module ppu #(
                 REFRESH_WAIT_UI_MAP: begin
                     bus_req_read <= 0;
                     if (bus_op_done) begin
-                        ui_tile_map[{refresh_cnt[7:0], 1'b0}] <= bus_rdata_latched[7:0];
-                        ui_tile_map[{refresh_cnt[7:0], 1'b1}] <= bus_rdata_latched[15:8];
+                        for (int k = 0; k < RD_BYTES; k++) begin
+                            ui_tile_map[9'(refresh_cnt * RD_BYTES + k)] <= bus_rdata_latched[8 * k +: 8];
+                        end
 
-                        if (refresh_cnt == 199) begin
+                        if (refresh_cnt == 400 / RD_BYTES - 1) begin
                             refresh_state <= REFRESH_OAM;
                             refresh_cnt <= 0;
                         end else begin
@@ -362,12 +709,13 @@ module ppu #(
                 end
 
                 // -------------------------------------------------------------
-                // OAM (128 entries * 4 bytes = 512 bytes = 256 words)
+                // OAM (128 entries * 4 bytes = 512 bytes), two reads per entry
+                // on the 16-bit path
                 // -------------------------------------------------------------
                 REFRESH_OAM: begin
                     if (bus_state == BUS_MASTER && !bus_op_done) begin
                         // Read low word
-                        bus_addr_latched <= OAM_MEM_OFFSET + 20'(refresh_cnt * 4);
+                        bus_addr_latched <= mem_base[BASE_OAM] + 20'(refresh_cnt * 4);
                         bus_req_read <= 1;
                         refresh_state <= REFRESH_WAIT_OAM_LOW;
                     end
@@ -375,11 +723,21 @@ module ppu #(
 
                 REFRESH_WAIT_OAM_LOW: begin
                     bus_req_read <= 0;
-                    if (bus_op_done) begin
-                        oam_temp_low <= bus_rdata_latched;
+                    if (bus_op_done && MEM_WIDTH == 32) begin
+                        oam[refresh_cnt[6:0]] <= bus_rdata_latched;
+
+                        if (refresh_cnt == MAX_OBJECTS - 1) begin
+                            refresh_state <= anim_on ? REFRESH_ANIM : REFRESH_DONE;
+                            refresh_cnt <= 0;
+                        end else begin
+                            refresh_cnt <= refresh_cnt + 1;
+                            refresh_state <= REFRESH_OAM;
+                        end
+                    end else if (bus_op_done) begin
+                        oam_temp_low <= bus_rdata_latched[15:0];
 
                         // Read high word
-                        bus_addr_latched <= OAM_MEM_OFFSET + 20'(refresh_cnt * 4 + 2);
+                        bus_addr_latched <= mem_base[BASE_OAM] + 20'(refresh_cnt * 4 + 2);
                         bus_req_read <= 1;
                         refresh_state <= REFRESH_WAIT_OAM_HIGH;
                     end
@@ -388,10 +746,11 @@ module ppu #(
                 REFRESH_WAIT_OAM_HIGH: begin
                     bus_req_read <= 0;
                     if (bus_op_done) begin
-                        oam[refresh_cnt[6:0]] <= {bus_rdata_latched, oam_temp_low};
+                        oam[refresh_cnt[6:0]] <= {bus_rdata_latched[15:0], oam_temp_low};
 
                         if (refresh_cnt == MAX_OBJECTS - 1) begin
-                            refresh_state <= REFRESH_DONE;
+                            refresh_state <= anim_on ? REFRESH_ANIM : REFRESH_DONE;
+                            refresh_cnt <= 0;
                         end else begin
                             refresh_cnt <= refresh_cnt + 1;
                             refresh_state <= REFRESH_OAM;
@@ -399,6 +758,33 @@ module ppu #(
                     end
                 end
 
+                // -------------------------------------------------------------
+                // Sprite animation descriptors (MAX_OBJECTS bytes), if enabled
+                // -------------------------------------------------------------
+                REFRESH_ANIM: begin
+                    if (bus_state == BUS_MASTER && !bus_op_done) begin
+                        bus_addr_latched <= ANIM_MEM_OFFSET + 20'(refresh_cnt * RD_BYTES);
+                        bus_req_read <= 1;
+                        refresh_state <= REFRESH_WAIT_ANIM;
+                    end
+                end
+
+                REFRESH_WAIT_ANIM: begin
+                    bus_req_read <= 0;
+                    if (bus_op_done) begin
+                        for (int k = 0; k < RD_BYTES; k++) begin
+                            anim_desc[7'(refresh_cnt * RD_BYTES + k)] <= bus_rdata_latched[8 * k +: 8];
+                        end
+
+                        if (refresh_cnt == MAX_OBJECTS / RD_BYTES - 1) begin
+                            refresh_state <= REFRESH_DONE;
+                        end else begin
+                            refresh_cnt <= refresh_cnt + 1;
+                            refresh_state <= REFRESH_ANIM;
+                        end
+                    end
+                end
+
                 REFRESH_DONE: begin
                     want_bus <= 0;
                     refresh_state <= REFRESH_IDLE;
@@ -420,6 +806,7 @@ module ppu #(
 
     // Loop and intermediate variables for object rendering
     integer i;
+    integer a;
     reg [31:0] object;
     reg [8:0] obj_x;
     reg [7:0] obj_y;
@@ -442,7 +829,22 @@ module ppu #(
             pixel_g <= 0;
             pixel_b <= 0;
             pixel_sync <= 0;
+            vblank <= 0;
+            te_idle <= 0;
             need_mem_refresh <= 0;
+            te_sync <= 0;
+            wait_te <= 0;
+            te_go <= 0;
+            for (a = 0; a < MAX_OBJECTS; a = a + 1) begin
+                anim_seen[a]  <= 0;
+                anim_step[a]  <= 0;
+                anim_frame[a] <= 0;
+            end
+            for (a = 0; a < CYCLE_RANGES; a = a + 1) begin
+                cycle_seen[a]  <= 0;
+                cycle_step[a]  <= 0;
+                cycle_phase[a] <= 0;
+            end
         end else begin
             // Background Rendering
             logic [5:0] bg_tile_x;
@@ -454,6 +856,8 @@ module ppu #(
             logic [7:0] bg_byte;
             logic [3:0] bg_pixel_val;
             logic [11:0] bg_tile_color;
+            logic [12:0] bg_px;
+            logic [11:0] bg_py;
 
             // UI Rendering
             logic [5:0] ui_tile_x;
@@ -467,143 +871,213 @@ module ppu #(
             logic [11:0] ui_tile_color;
             logic       ui_render = 0;
 
-            // Reset sync flag
+            // Reset sync flags
             pixel_sync <= 0;
+            vblank <= 0;
+
+            te_sync <= {te_sync[1:0], te};
+
+            // A TE wait with the synchronizer, the refresh and the bus all
+            // idle is a fixed point for as long as te stays low, which lets
+            // the simulation jump over it (Mud16System::set_idle_skip)
+            te_idle <= wait_te && te_sync == 0 && !te && !need_mem_refresh && !mem_refreshed &&
+                       refresh_state == REFRESH_IDLE && !want_bus && bus_state == IDLE;
 
             // Check for start of frame
-            if (pixel_x == 0 && pixel_y == 0 && !mem_refreshed) begin
-                need_mem_refresh <= 1;
+            if (pixel_x == 0 && pixel_y == 0 && (wait_te || (!mem_refreshed && !te_go))) begin
+                if (wait_te) begin
+                    need_mem_refresh <= 0;
+                    if (te_sync[1] && !te_sync[2]) begin
+                        wait_te <= 0;
+                        te_go <= 1;
+                    end
+                end else begin
+                    need_mem_refresh <= 1;
+                end
+                pixel_sync <= 0;
+                pixel_r <= 0;
+                pixel_g <= 0;
+                pixel_b <= 0;
+            end else if (pixel_x == 0 && pixel_y == 0 && mem_refreshed && te_sync_on && !te_go) begin
+                // Refreshed, now wait for TE (unless it was just seen)
+                need_mem_refresh <= 0;
+                wait_te <= 1;
                 pixel_sync <= 0;
                 pixel_r <= 0;
                 pixel_g <= 0;
                 pixel_b <= 0;
             end else begin
                 need_mem_refresh <= 0;
+                te_go <= 0;
+
+                // A held frame leaves the panel's GRAM alone: no pixels go
+                // out and the render pipeline idles (its clock enable on the
+                // FPGA), only the counters below keep the frame timing
+                if (!frame_held) begin
+                    // Get background tile data; in world map mode the map is
+                    // the fetched window and the fine scroll shifts it
+                    bg_px = pixel_x + 13'(bg_fine_x);
+                    bg_py = pixel_y + 12'(bg_fine_y);
+                    bg_tile_x = bg_px[8:3]; // pixel_x / 8
+                    bg_tile_y = bg_py[8:3]; // pixel_y / 8
+                    bg_tile_idx = bg_tile_map[{bg_tile_y, bg_tile_x}]; // 64x64 map
+                    if (remap_on) bg_tile_idx = tile_remap[bg_tile_idx];
 
-                // Get background tile data
-                // TODO: add scrolling offsets
-                bg_tile_x = pixel_x[8:3]; // pixel_x / 8
-                bg_tile_y = pixel_y[8:3]; // pixel_y / 8
-                bg_tile_idx = bg_tile_map[{bg_tile_y, bg_tile_x}]; // 64x64 map
-
-                // Local pixel within tile
-                bg_local_x = pixel_x[2:0];
-                bg_local_y = pixel_y[2:0];
-
-                // 32 bytes per tile, 4 bytes per row (8 pixels / 2)
-                bg_byte_addr = (14'(bg_tile_idx) << 5) + (14'(bg_local_y) << 2) + (14'(bg_local_x) >> 1);
-                bg_byte = tile_memory[bg_byte_addr];
-                bg_pixel_val = bg_local_x[0] ? bg_byte[3:0] : bg_byte[7:4];
-
-                // Get color from palette
-                bg_tile_color = palette[bg_palette][bg_pixel_val];
-
-                // Set pixel to background color initially
-                // TODO: possible optimization if other pixels are going to be rendered on top anyway
-                pixel_sync <= 1; // Always output a pixel
-                if (bg_pixel_val != 0) begin
-                    pixel_r <= {bg_tile_color[11:8], bg_tile_color[11:8]};
-                    pixel_g <= {bg_tile_color[7:4], bg_tile_color[7:4]};
-                    pixel_b <= {bg_tile_color[3:0], bg_tile_color[3:0]};
-                end else begin
-                    // sky
-                    pixel_r <= 8'h88;
-                    pixel_g <= 8'hDD;
-                    pixel_b <= 8'hFF;
-                end
-
-                // Loop through objects
-                // TODO: possible optimization: only check objects that are likely to be on this scanline
-                for (i = 0; i < MAX_OBJECTS; i = i + 1) begin
-                    object = oam[i];
-
-                    // Check if object is enabled
-                    if (object[31]) begin
-                        obj_x       = object[8:0];
-                        obj_y       = object[16:9];
-                        tile_idx    = object[25:17];
-                        palette_idx <= object[28:26];
-                        hflip       = object[29];
-                        vflip       = object[30];
-
-                        // Check if current pixel is within this object's bounds
-                        if (pixel_x >= 13'(obj_x) && pixel_x < 13'(obj_x) + 13'd8 && pixel_y >= 12'(obj_y) && pixel_y < 12'(obj_y) + 12'd8) begin
-                            local_x <= 3'(pixel_x - 13'(obj_x));
-                            local_y <= 3'(pixel_y - 12'(obj_y));
-
-                            // Apply flip transformations
-                            if (hflip) local_x <= 3'd7 - local_x;
-                            if (vflip) local_y <= 3'd7 - local_y;
-
-                            // Get tile
-                            tile_base = tile_idx * 13'd32; // 32 bytes per tile
-                            byte_offset = tile_base + (13'(local_y) * 13'd4) + (13'(local_x) >> 1);
-
-                            tile_byte = tile_memory[14'(byte_offset)];
-                            pixel_data = (local_x[0]) ? tile_byte[3:0] : tile_byte[7:4]; // Use lowest bit of x position to check even or odd for nibble selection
-
-                            if (pixel_data == 4'b1111) begin
-                                // Transparent pixel, skip
-                                continue;
-                            end
+                    // Local pixel within tile
+                    bg_local_x = bg_px[2:0];
+                    bg_local_y = bg_py[2:0];
+
+                    // 32 bytes per tile, 4 bytes per row (8 pixels / 2)
+                    bg_byte_addr = (14'(bg_tile_idx) << 5) + (14'(bg_local_y) << 2) + (14'(bg_local_x) >> 1);
+                    bg_byte = tile_memory[bg_byte_addr];
+                    bg_pixel_val = bg_local_x[0] ? bg_byte[3:0] : bg_byte[7:4];
+
+                    // Get color from palette
+                    bg_tile_color = palette[bg_palette][cycle_index(bg_palette, bg_pixel_val)];
+
+                    // Set pixel to background color initially
+                    // TODO: possible optimization if other pixels are going to be rendered on top anyway
+                    pixel_sync <= 1; // Always output a pixel
+                    if (bg_pixel_val != 0) begin
+                        pixel_r <= {bg_tile_color[11:8], bg_tile_color[11:8]};
+                        pixel_g <= {bg_tile_color[7:4], bg_tile_color[7:4]};
+                        pixel_b <= {bg_tile_color[3:0], bg_tile_color[3:0]};
+                    end else begin
+                        // sky
+                        pixel_r <= 8'h88;
+                        pixel_g <= 8'hDD;
+                        pixel_b <= 8'hFF;
+                    end
 
-                            // Set pixel color
-                            color = palette[palette_idx][pixel_data];
-                            pixel_r <= {color[11:8], color[11:8]};
-                            pixel_g <= {color[7:4], color[7:4]};
-                            pixel_b <= {color[3:0], color[3:0]};
-                            pixel_sync <= 1; // Indicate pixel drawn
+                    // Loop through objects
+                    // TODO: possible optimization: only check objects that are likely to be on this scanline
+                    for (i = 0; i < MAX_OBJECTS; i = i + 1) begin
+                        object = oam[i];
+
+                        // Check if object is enabled
+                        if (object[31]) begin
+                            obj_x       = object[8:0];
+                            obj_y       = object[16:9];
+                            tile_idx    = object[25:17];
+                            if (anim_on) tile_idx = tile_idx + 9'(anim_frame[i]);
+                            palette_idx <= object[28:26];
+                            hflip       = object[29];
+                            vflip       = object[30];
+
+                            // Check if current pixel is within this object's bounds
+                            if (pixel_x >= 13'(obj_x) && pixel_x < 13'(obj_x) + 13'd8 && pixel_y >= 12'(obj_y) && pixel_y < 12'(obj_y) + 12'd8) begin
+                                local_x <= 3'(pixel_x - 13'(obj_x));
+                                local_y <= 3'(pixel_y - 12'(obj_y));
+
+                                // Apply flip transformations
+                                if (hflip) local_x <= 3'd7 - local_x;
+                                if (vflip) local_y <= 3'd7 - local_y;
+
+                                // Get tile
+                                tile_base = tile_idx * 13'd32; // 32 bytes per tile
+                                byte_offset = tile_base + (13'(local_y) * 13'd4) + (13'(local_x) >> 1);
+
+                                tile_byte = tile_memory[14'(byte_offset)];
+                                pixel_data = (local_x[0]) ? tile_byte[3:0] : tile_byte[7:4]; // Use lowest bit of x position to check even or odd for nibble selection
+
+                                if (pixel_data == 4'b1111) begin
+                                    // Transparent pixel, skip
+                                    continue;
+                                end
+
+                                // Set pixel color
+                                color = palette[palette_idx][cycle_index(palette_idx[2:0], pixel_data)];
+                                pixel_r <= {color[11:8], color[11:8]};
+                                pixel_g <= {color[7:4], color[7:4]};
+                                pixel_b <= {color[3:0], color[3:0]};
+                                pixel_sync <= 1; // Indicate pixel drawn
+                            end
                         end
                     end
-                end
 
-                // Render UI
+                    // Render UI
 
-                // Get UI tile data
-                ui_tile_x = pixel_x[8:3]; // pixel_x / 8
-                ui_tile_y = pixel_y[8:3]; // pixel_y / 8
+                    // Get UI tile data
+                    ui_tile_x = pixel_x[8:3]; // pixel_x / 8
+                    ui_tile_y = pixel_y[8:3]; // pixel_y / 8
 
-                if (ui_tile_y < 5) begin
-                    ui_render = 1;
-                end
+                    if (ui_tile_y < 5) begin
+                        ui_render = 1;
+                    end
 
-                if (ui_tile_y >= 25) begin
-                    ui_render = 1;
-                    ui_tile_y = ui_tile_y - 5'd20; // Shift to 0-4 range as UI is at bottom
-                end
+                    if (ui_tile_y >= 25) begin
+                        ui_render = 1;
+                        ui_tile_y = ui_tile_y - 5'd20; // Shift to 0-4 range as UI is at bottom
+                    end
 
-                // Render UI if in UI area (top and bottom bar)
-                if (ui_render) begin
-                    ui_tile_idx = ui_tile_map[ui_tile_y * 40 + ui_tile_x];
+                    // Render UI if in UI area (top and bottom bar)
+                    if (ui_render) begin
+                        ui_tile_idx = ui_tile_map[ui_tile_y * 40 + ui_tile_x];
+                        if (remap_on) ui_tile_idx = tile_remap[ui_tile_idx];
 
-                    // Local pixel within tile
-                    ui_local_x = pixel_x[2:0];
-                    ui_local_y = pixel_y[2:0];
+                        // Local pixel within tile
+                        ui_local_x = pixel_x[2:0];
+                        ui_local_y = pixel_y[2:0];
 
-                    // 32 bytes per tile, 4 bytes per row (8 pixels / 2)
-                    ui_byte_addr = (14'(ui_tile_idx) << 5) + (14'(ui_local_y) << 2) + (14'(ui_local_x) >> 1);
-                    ui_byte = tile_memory[ui_byte_addr];
-                    ui_pixel_val = ui_local_x[0] ? ui_byte[3:0] : ui_byte[7:4]; // Select nibble (2 pixels per byte)
+                        // 32 bytes per tile, 4 bytes per row (8 pixels / 2)
+                        ui_byte_addr = (14'(ui_tile_idx) << 5) + (14'(ui_local_y) << 2) + (14'(ui_local_x) >> 1);
+                        ui_byte = tile_memory[ui_byte_addr];
+                        ui_pixel_val = ui_local_x[0] ? ui_byte[3:0] : ui_byte[7:4]; // Select nibble (2 pixels per byte)
 
-                    // Get color from palette
-                    if (ui_tile_y < 5) begin
-                        ui_tile_color = palette[ui_top_palette][ui_pixel_val];
-                    end else begin
-                        ui_tile_color = palette[ui_bottom_palette][ui_pixel_val];
-                    end
+                        // Get color from palette
+                        if (ui_tile_y < 5) begin
+                            ui_tile_color = palette[ui_top_palette][cycle_index(ui_top_palette, ui_pixel_val)];
+                        end else begin
+                            ui_tile_color = palette[ui_bottom_palette][cycle_index(ui_bottom_palette, ui_pixel_val)];
+                        end
 
-                    // Set pixel
-                    if (ui_pixel_val != 0) begin
-                        pixel_r <= {ui_tile_color[11:8], ui_tile_color[11:8]};
-                        pixel_g <= {ui_tile_color[7:4], ui_tile_color[7:4]};
-                        pixel_b <= {ui_tile_color[3:0], ui_tile_color[3:0]};
+                        // Set pixel
+                        if (ui_pixel_val != 0) begin
+                            pixel_r <= {ui_tile_color[11:8], ui_tile_color[11:8]};
+                            pixel_g <= {ui_tile_color[7:4], ui_tile_color[7:4]};
+                            pixel_b <= {ui_tile_color[3:0], ui_tile_color[3:0]};
+                        end
                     end
                 end
+
                 // Timing counters
                 if (pixel_x == DISP_WIDTH - 1) begin
                     pixel_x <= 0;
                     if (pixel_y == DISP_HEIGHT - 1) begin
                         pixel_y <= 0;
+                        vblank  <= 1;
+
+                        // Vblank: advance the sprite animations
+                        if (anim_on) begin
+                            for (a = 0; a < MAX_OBJECTS; a = a + 1) begin
+                                if (anim_desc[a] != anim_seen[a]) begin
+                                    anim_seen[a]  <= anim_desc[a];
+                                    anim_step[a]  <= 0;
+                                    anim_frame[a] <= 0;
+                                end else if (anim_step[a] != anim_desc[a][7:3]) begin
+                                    anim_step[a] <= anim_step[a] + 1;
+                                end else begin
+                                    anim_step[a]  <= 0;
+                                    anim_frame[a] <= anim_frame[a] == anim_desc[a][2:0] ? 3'd0 : anim_frame[a] + 1;
+                                end
+                            end
+                        end
+
+                        // ... and the colour cycles
+                        if (cycle_on) begin
+                            for (a = 0; a < CYCLE_RANGES; a = a + 1) begin
+                                if (ppu_regs[8 + a] != cycle_seen[a]) begin
+                                    cycle_seen[a]  <= ppu_regs[8 + a];
+                                    cycle_step[a]  <= 0;
+                                    cycle_phase[a] <= 0;
+                                end else if (cycle_step[a] != cycle_seen[a][15:11]) begin
+                                    cycle_step[a] <= cycle_step[a] + 1;
+                                end else begin
+                                    cycle_step[a]  <= 0;
+                                    cycle_phase[a] <= cycle_phase[a] == cycle_seen[a][10:7] ? 4'd0 : cycle_phase[a] + 1;
+                                end
+                            end
+                        end
                     end else begin
                         pixel_y <= pixel_y + 1;
                     end
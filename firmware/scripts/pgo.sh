@@ -0,0 +1,75 @@
+#!/usr/bin/env bash
+#
+# Profile-guided + LTO build of the headless simulator.
+#
+# Builds a plain Release mud16_bench as the baseline, then an instrumented
+# one (MUD16_PGO=generate), runs the training set below, rebuilds the same
+# tree with the profiles and LTO (MUD16_PGO=use, MUD16_LTO=ON) and writes
+# <out>/pgo_report.md comparing both builds on the demo and stress scenes.
+#
+# Training set: demo and stress scenes in both tick modes, plus the
+# randomized CPU timings from mud16_tickcheck, so the arbitration paths are
+# covered too.
+#
+# usage: scripts/pgo.sh [out_dir] [frames]
+#
+
+set -euo pipefail
+
+here="$(cd "$(dirname "$0")/.." && pwd)"
+out="${1:-$here/_pgo_build}"
+frames="${2:-300}"
+train_frames=$(( frames / 2 > 0 ? frames / 2 : 1 ))
+
+common=(-DCMAKE_BUILD_TYPE=Release -DMUD16_BUILD_GUI=OFF)
+
+echo "== release build"
+cmake -S "$here" -B "$out/release" "${common[@]}"
+cmake --build "$out/release" --target mud16_bench -j"$(nproc)"
+
+echo "== instrumented build"
+data="$out/pgo/pgo-data"
+rm -rf "$data"
+cmake -S "$here" -B "$out/pgo" "${common[@]}" -DMUD16_PGO=generate -DMUD16_LTO=OFF
+cmake --build "$out/pgo" --target mud16_bench mud16_tickcheck -j"$(nproc)"
+
+echo "== training"
+for scene in demo stress; do
+    for tick in full fast; do
+        "$out/pgo/mud16_bench" --scene "$scene" --frames "$train_frames" --tick "$tick" --validate 10 > /dev/null
+    done
+done
+"$out/pgo/mud16_tickcheck" --frames 20 --seeds 2 > /dev/null
+
+# Clang writes raw profiles that have to be merged first
+shopt -s nullglob
+raw=("$data"/*.profraw)
+if [ ${#raw[@]} -gt 0 ]; then
+    llvm-profdata merge -o "$data/mud16.profdata" "${raw[@]}"
+fi
+
+echo "== optimized build"
+cmake -S "$here" -B "$out/pgo" "${common[@]}" -DMUD16_PGO=use -DMUD16_LTO=ON
+cmake --build "$out/pgo" --target mud16_bench -j"$(nproc)"
+
+speed() {
+    "$1" --scene "$2" --frames "$frames" | awk '/^speed/ { print $2 }'
+}
+
+report="$out/pgo_report.md"
+{
+    echo "# PGO + LTO vs. plain Release ($frames frames per scene)"
+    echo
+    echo "| scene | release Mcycles/s | pgo+lto Mcycles/s | speedup |"
+    echo "|-------|------------------:|------------------:|--------:|"
+} > "$report"
+
+for scene in demo stress; do
+    base=$(speed "$out/release/mud16_bench" "$scene")
+    pgo=$(speed "$out/pgo/mud16_bench" "$scene")
+    awk -v s="$scene" -v a="$base" -v b="$pgo" \
+        'BEGIN { printf "| %s | %.2f | %.2f | %.2fx |\n", s, a, b, a > 0 ? b / a : 0 }' >> "$report"
+done
+
+cat "$report"
+echo "report: $report"
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""Map a gprof or perf profile of a --prof-cfuncs build back to ppu.sv.
+
+With --prof-cfuncs every Verilated C function holds one RTL statement and is
+named ..._PROF__<module>__l<line>. This script sums the self time of those
+functions per source line and per always block and prints a markdown report.
+
+Input is either `gprof -b -p` (flat profile) or
+`perf report --stdio --no-children --sort symbol` output.
+
+usage: prof_report.py --source ppu.sv [--title NAME] [--top N] profile.txt
+"""
+
+import argparse
+import re
+import sys
+from collections import defaultdict
+
+PROF_RE = re.compile(r"__PROF__([A-Za-z0-9_]+?)__l?(\d+)")
+PCT_RE = re.compile(r"^\s*([0-9]+(?:\.[0-9]+)?)%?\s")
+
+
+def parse_profile(path):
+    """Yields (self_percent, symbol, raw line) for each profile row."""
+    with open(path, encoding="utf-8", errors="replace") as f:
+        for line in f:
+            m = PCT_RE.match(line)
+            if not m:
+                continue
+            pct = float(m.group(1))
+            # gprof: name is the last column; perf: after "[.]"
+            if "[.]" in line:
+                symbol = line.split("[.]", 1)[1].strip()
+            else:
+                cols = line.split(None, 6)
+                symbol = cols[-1].strip() if len(cols) > 1 else ""
+            if symbol:
+                yield pct, symbol, line
+
+
+def find_blocks(source_lines):
+    """Maps each line number to the always block it sits in.
+
+    A block is named after a comment just above it, or else after the last
+    divider-wrapped section heading.
+    """
+    blocks = {}
+    current = "(module scope)"
+    section = ""
+    comment, comment_line = "", -100
+    prev_divider = False
+    for n, text in enumerate(source_lines, start=1):
+        stripped = text.strip()
+        is_divider = stripped.startswith("//") and set(stripped[2:].strip()) <= {"-"}
+        if stripped.startswith("//") and not is_divider:
+            comment, comment_line = stripped[2:].strip(), n
+            if prev_divider:
+                section = comment
+        if re.match(r"always(_ff|_comb|_latch)?\b", stripped) or stripped.startswith("assign "):
+            name = comment if n - comment_line <= 8 else (section or stripped.split("(")[0])
+            current = "%s @ line %d" % (name, n)
+        blocks[n] = current
+        prev_divider = is_divider
+    return blocks
+
+
+def enclosing_case(source_lines, line):
+    """Nearest state label above `line`, e.g. REFRESH_TILES."""
+    for n in range(line, 0, -1):
+        m = re.match(r"\s*([A-Z][A-Z0-9_]+)\s*:\s*begin", source_lines[n - 1])
+        if m:
+            return m.group(1)
+        if re.match(r"\s*always", source_lines[n - 1]):
+            break
+    return ""
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--source", required=True, help="ppu.sv")
+    ap.add_argument("--module", default="ppu")
+    ap.add_argument("--title", default="")
+    ap.add_argument("--top", type=int, default=25)
+    ap.add_argument("profile")
+    args = ap.parse_args()
+
+    with open(args.source, encoding="utf-8") as f:
+        source = f.read().splitlines()
+    blocks = find_blocks(source)
+
+    per_line = defaultdict(float)
+    per_block = defaultdict(float)
+    other = defaultdict(float)
+    total = 0.0
+
+    for pct, symbol, raw in parse_profile(args.profile):
+        total += pct
+        m = PROF_RE.search(raw)
+        if m and m.group(1) == args.module:
+            line = int(m.group(2))
+            per_line[line] += pct
+            per_block[blocks.get(line, "?")] += pct
+        else:
+            other[symbol.split("(")[0]] += pct
+
+    attributed = sum(per_line.values())
+    out = sys.stdout
+    out.write("## %s\n\n" % (args.title or args.profile))
+    out.write("%.1f%% of samples attributed to `%s` RTL, %.1f%% elsewhere.\n\n"
+              % (attributed, args.module, total - attributed))
+
+    out.write("### By always block\n\n| %self | block |\n|---:|---|\n")
+    for block, pct in sorted(per_block.items(), key=lambda kv: -kv[1]):
+        out.write("| %.2f | %s |\n" % (pct, block))
+
+    out.write("\n### Hottest lines\n\n| %self | line | state | source |\n|---:|---:|---|---|\n")
+    for line, pct in sorted(per_line.items(), key=lambda kv: -kv[1])[:args.top]:
+        text = source[line - 1].strip() if 0 < line <= len(source) else "?"
+        out.write("| %.2f | %d | %s | `%s` |\n"
+                  % (pct, line, enclosing_case(source, line), text.replace("|", "\\|")))
+
+    out.write("\n### Outside the RTL\n\n| %self | function |\n|---:|---|\n")
+    for name, pct in sorted(other.items(), key=lambda kv: -kv[1])[:10]:
+        out.write("| %.2f | `%s` |\n" % (pct, name))
+    out.write("\n")
+
+
+if __name__ == "__main__":
+    main()
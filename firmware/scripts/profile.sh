@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+#
+# Profiles Vppu::eval() per ppu.sv line.
+#
+# Builds a headless mud16_bench with Verilator --prof-cfuncs (one C function
+# per RTL statement), runs the demo and stress scenes under gprof or perf and
+# writes <build>/profile_report.md via prof_report.py.
+#
+# usage: scripts/profile.sh [gprof|perf] [build_dir] [frames]
+#
+
+set -euo pipefail
+
+tool="${1:-gprof}"
+here="$(cd "$(dirname "$0")/.." && pwd)"
+build="${2:-$here/_profile_build}"
+frames="${3:-20}"
+
+case "$tool" in
+    gprof|perf) ;;
+    *) echo "usage: $0 [gprof|perf] [build_dir] [frames]" >&2; exit 2 ;;
+esac
+
+cmake -S "$here" -B "$build" \
+    -DCMAKE_BUILD_TYPE=RelWithDebInfo \
+    -DMUD16_BUILD_GUI=OFF \
+    -DMUD16_PROFILE="$tool"
+cmake --build "$build" --target mud16_bench -j"$(nproc)"
+
+report="$build/profile_report.md"
+{
+    echo "# ppu.sv eval profile ($tool, $frames frames per scene)"
+    echo
+} > "$report"
+
+for scene in demo stress; do
+    echo "== $scene"
+    pushd "$build" > /dev/null
+    rm -f gmon.out perf.data
+    if [ "$tool" = gprof ]; then
+        ./mud16_bench --scene "$scene" --frames "$frames" | tee "bench_$scene.txt"
+        gprof -b -p ./mud16_bench gmon.out > "profile_$scene.txt"
+    else
+        perf record -q -o perf.data ./mud16_bench --scene "$scene" --frames "$frames" | tee "bench_$scene.txt"
+        perf report -i perf.data --stdio --no-children --sort symbol > "profile_$scene.txt"
+    fi
+    popd > /dev/null
+
+    python3 "$here/scripts/prof_report.py" --source "$here/ppu.sv" --title "$scene" \
+        "$build/profile_$scene.txt" >> "$report"
+    {
+        echo '```'
+        cat "$build/bench_$scene.txt"
+        echo '```'
+        echo
+    } >> "$report"
+done
+
+echo "report: $report"
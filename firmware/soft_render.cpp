@@ -0,0 +1,535 @@
+#include "soft_render.h"
+#include "vram_init_data.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MUD16_SOFT_RENDER_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace soft_render {
+
+using L = vram_init::Layout;
+
+static constexpr uint32_t sky_rgba = 0xFFFFDD88; // 88 DD FF, as bytes R G B A
+
+// 12-bit palette entry to RGBA8 in memory order, nibbles doubled like ppu.sv
+static inline uint32_t expand(uint16_t c) {
+    uint32_t r = (c >> 8) & 0xF, g = (c >> 4) & 0xF, b = c & 0xF;
+    return 0xFF000000u | (b * 0x11) << 16 | (g * 0x11) << 8 | (r * 0x11);
+}
+
+static inline uint16_t read16(const uint8_t* ram, std::size_t size, std::size_t addr) {
+    return addr + 1 < size ? static_cast<uint16_t>(ram[addr] | ram[addr + 1] << 8) : 0;
+}
+
+void Vram::from_ram(const uint8_t* ram, std::size_t size, Vram& out) {
+    out.regs = ppu_regs::Regs::from_ram(ram, size);
+    const std::size_t palette_base = out.regs.palette_base(), tile_base = out.regs.tile_base();
+    const std::size_t bg_map_base = out.regs.bg_map_base(), ui_map_base = out.regs.ui_map_base();
+    const std::size_t oam_base = out.regs.oam_base();
+
+    for (int p = 0; p < 8; p++) {
+        for (int c = 0; c < 16; c++) {
+            out.palette[p][c] = read16(ram, size, palette_base + (p * 16 + c) * 2) & 0xFFF;
+        }
+    }
+    for (std::size_t i = 0; i < sizeof(out.tiles); i++) {
+        out.tiles[i] = tile_base + i < size ? ram[tile_base + i] : 0;
+    }
+    for (int i = 0; i < ppu_regs::remap_entries; i++) {
+        const std::size_t a = L::remap_base + i;
+        out.remap[i] = !out.regs.tile_remap() ? static_cast<uint8_t>(i) : a < size ? ram[a] : 0;
+    }
+    if (out.regs.world_map()) {
+        std::memset(out.bg_map, 0, sizeof(out.bg_map));
+        for (int wy = 0; wy < ppu_regs::window_h(height); wy++) {
+            for (int wx = 0; wx < ppu_regs::window_w(width); wx++) {
+                out.bg_map[wy * 64 + wx] = out.regs.world_tile(ram, size, wx, wy);
+            }
+        }
+    } else {
+        for (std::size_t i = 0; i < sizeof(out.bg_map); i++) {
+            out.bg_map[i] = bg_map_base + i < size ? ram[bg_map_base + i] : 0;
+        }
+    }
+    for (std::size_t i = 0; i < sizeof(out.ui_map); i++) {
+        out.ui_map[i] = ui_map_base + i < size ? ram[ui_map_base + i] : 0;
+    }
+    for (int i = 0; i < 128; i++) {
+        out.oam[i] = read16(ram, size, oam_base + i * 4) |
+                     static_cast<uint32_t>(read16(ram, size, oam_base + i * 4 + 2)) << 16;
+        out.anim[i] = out.regs.sprite_anim() && L::anim_base + i < size ? ram[L::anim_base + i] : 0;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Sprite animation
+// -----------------------------------------------------------------------------
+
+// The OAM word with the animation frame added to its tile
+static inline uint32_t animated(const Vram& vram, const State& state, int i) {
+    const uint32_t word = vram.oam[i];
+    if (!vram.regs.sprite_anim()) return word;
+    const uint32_t tile = (((word >> 17) & 0x1FF) + state.anim_frame[i]) & 0x1FF;
+    return (word & ~(0x1FFu << 17)) | tile << 17;
+}
+
+// The palette as RGBA, with the colour cycles' current phases applied
+static void expand_palette(const Vram& vram, const State& state, uint32_t* out) {
+    for (int p = 0; p < 8; p++) {
+        for (int c = 0; c < 16; c++) {
+            int idx = c;
+            if (vram.regs.color_cycle()) {
+                for (int r = 0; r < ppu_regs::cycle_ranges; r++) {
+                    if (ppu_regs::cycle_covers(state.cycle_seen[r], p, c)) {
+                        idx = ppu_regs::cycle_index(state.cycle_seen[r], state.cycle_phase[r], p, c);
+                    }
+                }
+            }
+            out[p * 16 + c] = expand(vram.palette[p][idx]);
+        }
+    }
+}
+
+// What ppu.sv does after the last pixel of a frame
+static void advance_animation(const Vram& vram, State& state) {
+    if (vram.regs.color_cycle()) {
+        for (int r = 0; r < ppu_regs::cycle_ranges; r++) {
+            const uint16_t reg = vram.regs.word[ppu_regs::CYCLE0 + r];
+            if (reg != state.cycle_seen[r]) {
+                state.cycle_seen[r]  = reg;
+                state.cycle_step[r]  = 0;
+                state.cycle_phase[r] = 0;
+            } else if (state.cycle_step[r] != reg >> 11) {
+                state.cycle_step[r]++;
+            } else {
+                state.cycle_step[r]  = 0;
+                state.cycle_phase[r] = state.cycle_phase[r] == ((reg >> 7) & 0xF) ? 0 : state.cycle_phase[r] + 1;
+            }
+        }
+    }
+
+    if (!vram.regs.sprite_anim()) return;
+    for (int i = 0; i < 128; i++) {
+        const uint8_t desc = vram.anim[i];
+        if (desc != state.anim_seen[i]) {
+            state.anim_seen[i]  = desc;
+            state.anim_step[i]  = 0;
+            state.anim_frame[i] = 0;
+        } else if (state.anim_step[i] != desc >> 3) {
+            state.anim_step[i]++;
+        } else {
+            state.anim_step[i]  = 0;
+            state.anim_frame[i] = state.anim_frame[i] == (desc & 7) ? 0 : state.anim_frame[i] + 1;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Object decode shared by both renderers
+// -----------------------------------------------------------------------------
+
+struct Object {
+    bool    enabled;
+    int32_t x, y;
+    int32_t tile_base; // tile_idx * 32, truncated to 13 bits like ppu.sv
+    int32_t palette;
+    bool    hflip, vflip;
+};
+
+static inline Object decode(uint32_t word) {
+    Object o;
+    o.enabled   = (word >> 31) & 1;
+    o.x         = word & 0x1FF;
+    o.y         = (word >> 9) & 0xFF;
+    o.tile_base = (((word >> 17) & 0x1FF) * 32) & 0x1FFF;
+    o.palette   = (word >> 26) & 0x7;
+    o.hflip     = (word >> 29) & 1;
+    o.vflip     = (word >> 30) & 1;
+    return o;
+}
+
+// The refresh FSM walks palette_idx up to 7 before every frame, and every
+// rendered pixel then sets it to the palette of each enabled object in turn,
+// so after the first pixel it holds the last enabled object's palette.
+static inline bool last_enabled_palette(const Object* objects, int32_t& palette) {
+    for (int i = 127; i >= 0; i--) {
+        if (objects[i].enabled) {
+            palette = objects[i].palette;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Objects that can cover each 8-pixel column of one row, in OAM order.
+// An object overlaps at most two columns.
+struct RowBins {
+    static constexpr int columns = width / 8 + 1;
+
+    uint8_t count[columns];
+    uint8_t list[columns][128];
+
+    void clear() { std::memset(count, 0, sizeof(count)); }
+
+    void add(int i, int x) {
+        int first = x >> 3, last = (x + 7) >> 3;
+        if (first < columns) list[first][count[first]++] = static_cast<uint8_t>(i);
+        if (last != first && last < columns) list[last][count[last]++] = static_cast<uint8_t>(i);
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Scalar reference
+// -----------------------------------------------------------------------------
+
+void render(const Vram& vram, State& state, uint8_t* rgba) {
+    uint32_t palette[8][16];
+    expand_palette(vram, state, palette[0]);
+
+    Object objects[128];
+    for (int i = 0; i < 128; i++) objects[i] = decode(animated(vram, state, i));
+    int32_t last_palette = 0;
+    const bool any_enabled = last_enabled_palette(objects, last_palette);
+
+    int32_t lx = state.local_x, ly = state.local_y;
+    int32_t pal = 7;
+
+    const int fine_x = vram.regs.fine_x(), fine_y = vram.regs.fine_y();
+
+    RowBins bins;
+    for (int y = 0; y < height; y++) {
+        bins.clear();
+        for (int i = 0; i < 128; i++) {
+            if (objects[i].enabled && y >= objects[i].y && y < objects[i].y + 8) bins.add(i, objects[i].x);
+        }
+        const int ty = y >> 3;
+        const int by = y + fine_y;
+
+        for (int x = 0; x < width; x++) {
+            const int      tx     = x >> 3;
+            const int      n      = bins.count[tx];
+            const uint8_t* active = bins.list[tx];
+
+            // Background, palette 0, shifted by the fine scroll
+            const int bx  = x + fine_x;
+            uint8_t  tile = vram.remap[vram.bg_map[(by >> 3) * 64 + (bx >> 3)]];
+            uint8_t  b    = vram.tiles[(tile << 5) + ((by & 7) << 2) + ((bx & 7) >> 1)];
+            uint8_t  val  = (bx & 1) ? (b & 0xF) : (b >> 4);
+            uint32_t out  = val ? palette[0][val] : sky_rgba;
+
+            // Objects, with the registers as the previous pixel left them
+            int32_t next_lx = lx, next_ly = ly;
+            for (int k = 0; k < n; k++) {
+                const Object& o = objects[active[k]];
+                if (x < o.x || x >= o.x + 8) continue;
+
+                next_lx = o.hflip ? 7 - lx : (x - o.x) & 7;
+                next_ly = o.vflip ? 7 - ly : (y - o.y) & 7;
+
+                uint8_t tb   = vram.tiles[(o.tile_base + ly * 4 + (lx >> 1)) & 0x1FFF];
+                uint8_t data = (lx & 1) ? (tb & 0xF) : (tb >> 4);
+                if (data == 0xF) continue;
+                out = palette[pal][data];
+            }
+
+            // UI bars: tile rows 0-4 and 25-29, palette 0
+            if (ty < 5 || ty >= 25) {
+                int     row = ty < 5 ? ty : ty - 20;
+                uint8_t ui  = vram.remap[vram.ui_map[row * 40 + tx]];
+                uint8_t ub  = vram.tiles[(ui << 5) + ((y & 7) << 2) + ((x & 7) >> 1)];
+                uint8_t uv  = (x & 1) ? (ub & 0xF) : (ub >> 4);
+                if (uv) out = palette[0][uv];
+            }
+
+            std::memcpy(rgba + (static_cast<std::size_t>(y) * width + x) * 4, &out, 4);
+
+            lx = next_lx;
+            ly = next_ly;
+            if (any_enabled) pal = last_palette;
+        }
+    }
+
+    state.local_x     = static_cast<uint8_t>(lx);
+    state.local_y     = static_cast<uint8_t>(ly);
+    state.palette_idx = static_cast<uint8_t>(pal);
+    advance_animation(vram, state);
+}
+
+// -----------------------------------------------------------------------------
+// AVX2 batch: one scene per 32-bit lane
+// -----------------------------------------------------------------------------
+
+#ifdef MUD16_SOFT_RENDER_AVX2
+
+// Per-lane copies packed so that every lookup is one gather off a shared base
+struct BatchData {
+    static constexpr int tiles_at = 0;
+    static constexpr int bg_at    = 16384;
+    static constexpr int ui_at    = 16384 + 4096;
+    static constexpr int stride   = 16384 + 4096 + 512;
+
+    std::vector<uint8_t> bytes = std::vector<uint8_t>(batch_lanes * stride + 4); // +4: 32-bit gathers of the last byte
+    alignas(32) uint32_t palette[batch_lanes * 128];
+
+    // Objects transposed to [object][lane]
+    alignas(32) int32_t x[128][batch_lanes];
+    alignas(32) int32_t x_end[128][batch_lanes];
+    alignas(32) int32_t y[128][batch_lanes];
+    alignas(32) int32_t y_end[128][batch_lanes];
+    alignas(32) int32_t tile_base[128][batch_lanes];
+    alignas(32) int32_t enabled[128][batch_lanes]; // all ones / zero
+    alignas(32) int32_t hflip[128][batch_lanes];
+    alignas(32) int32_t vflip[128][batch_lanes];
+    alignas(32) int32_t last_palette[batch_lanes];
+    alignas(32) int32_t any_enabled[batch_lanes];
+
+    // Union over the lanes of the objects that can cover each row and column
+    RowBins rows[height];
+};
+
+static void pack(BatchData& d, const Vram* const* vram, const State* state, int count) {
+    std::vector<Object> objects(128);
+    std::vector<uint64_t> columns(height * 128, 0); // [row][object]: bit c set if some lane's copy covers column c
+
+    for (int l = 0; l < batch_lanes; l++) {
+        const Vram&  v = *vram[l < count ? l : 0]; // spare lanes repeat scene 0
+        const State& s = state[l < count ? l : 0];
+        uint8_t* base = d.bytes.data() + l * BatchData::stride;
+        std::memcpy(base + BatchData::tiles_at, v.tiles, sizeof(v.tiles));
+        // Maps are packed already remapped
+        for (std::size_t i = 0; i < sizeof(v.bg_map); i++) base[BatchData::bg_at + i] = v.remap[v.bg_map[i]];
+        for (std::size_t i = 0; i < sizeof(v.ui_map); i++) base[BatchData::ui_at + i] = v.remap[v.ui_map[i]];
+        expand_palette(v, s, d.palette + l * 128);
+
+        for (int i = 0; i < 128; i++) {
+            Object o = objects[i] = decode(animated(v, s, i));
+            d.x[i][l]         = o.x;
+            d.x_end[i][l]     = o.x + 8;
+            d.y[i][l]         = o.y;
+            d.y_end[i][l]     = o.y + 8;
+            d.tile_base[i][l] = o.tile_base;
+            d.enabled[i][l]   = o.enabled ? -1 : 0;
+            d.hflip[i][l]     = o.hflip ? -1 : 0;
+            d.vflip[i][l]     = o.vflip ? -1 : 0;
+            if (o.enabled) {
+                uint64_t bits = 0;
+                if ((o.x >> 3) < RowBins::columns)       bits |= 1ull << (o.x >> 3);
+                if (((o.x + 7) >> 3) < RowBins::columns) bits |= 1ull << ((o.x + 7) >> 3);
+                for (int y = o.y; y < o.y + 8 && y < height; y++) columns[y * 128 + i] |= bits;
+            }
+        }
+        int32_t pal = 0;
+        d.any_enabled[l]  = last_enabled_palette(objects.data(), pal) ? -1 : 0;
+        d.last_palette[l] = pal;
+    }
+
+    for (int y = 0; y < height; y++) {
+        RowBins& bins = d.rows[y];
+        bins.clear();
+        for (int i = 0; i < 128; i++) {
+            for (uint64_t bits = columns[y * 128 + i]; bits; bits &= bits - 1) {
+                int c = __builtin_ctzll(bits);
+                bins.list[c][bins.count[c]++] = static_cast<uint8_t>(i);
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static inline __m256i load_lanes(const int32_t* p) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// One byte per lane at lane_bytes + offset (the packed buffer is padded for it)
+__attribute__((target("avx2")))
+static inline __m256i gather_byte(const int* bytes, __m256i lane_bytes, __m256i offset) {
+    return _mm256_and_si256(_mm256_i32gather_epi32(bytes, _mm256_add_epi32(lane_bytes, offset), 1),
+                            _mm256_set1_epi32(0xFF));
+}
+
+// 8x8 transpose of 32-bit elements
+__attribute__((target("avx2")))
+static inline void transpose8(__m256i* r) {
+    __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]), t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+    __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]), t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+    __m256i t4 = _mm256_unpacklo_epi32(r[4], r[5]), t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+    __m256i t6 = _mm256_unpacklo_epi32(r[6], r[7]), t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+    __m256i u0 = _mm256_unpacklo_epi64(t0, t2), u1 = _mm256_unpackhi_epi64(t0, t2);
+    __m256i u2 = _mm256_unpacklo_epi64(t1, t3), u3 = _mm256_unpackhi_epi64(t1, t3);
+    __m256i u4 = _mm256_unpacklo_epi64(t4, t6), u5 = _mm256_unpackhi_epi64(t4, t6);
+    __m256i u6 = _mm256_unpacklo_epi64(t5, t7), u7 = _mm256_unpackhi_epi64(t5, t7);
+    r[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+    r[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+    r[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+    r[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+    r[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+    r[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+    r[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+    r[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+__attribute__((target("avx2")))
+static void render_avx2(const BatchData& d, const Vram* const* vram, State* state, uint8_t* const* rgba, int count) {
+    const int*     bytes   = reinterpret_cast<const int*>(d.bytes.data());
+    const int*     palette = reinterpret_cast<const int*>(d.palette);
+    const __m256i  lanes   = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i  lane_bytes   = _mm256_mullo_epi32(lanes, _mm256_set1_epi32(BatchData::stride));
+    const __m256i  lane_palette = _mm256_slli_epi32(lanes, 7);
+    const __m256i  nibble_mask  = _mm256_set1_epi32(0xF);
+    const __m256i  seven        = _mm256_set1_epi32(7);
+    const __m256i  zero         = _mm256_setzero_si256();
+    const __m256i  sky          = _mm256_set1_epi32(static_cast<int>(sky_rgba));
+    const __m256i  last_palette = load_lanes(d.last_palette);
+    const __m256i  any_enabled  = load_lanes(d.any_enabled);
+
+    alignas(32) int32_t init[3][batch_lanes];
+    for (int l = 0; l < batch_lanes; l++) {
+        const State& s = state[l < count ? l : 0];
+        init[0][l] = s.local_x;
+        init[1][l] = s.local_y;
+        init[2][l] = 7;
+    }
+    __m256i lx  = load_lanes(init[0]);
+    __m256i ly  = load_lanes(init[1]);
+    __m256i pal = load_lanes(init[2]);
+
+    __m256i group[8]; // one column of 8 pixels, [pixel][lane]
+    for (int y = 0; y < height; y++) {
+        const int      ty   = y >> 3;
+        const __m256i  Y    = _mm256_set1_epi32(y);
+        const RowBins& bins = d.rows[y];
+        const bool     ui_row = ty < 5 || ty >= 25;
+        const int      ui_ty  = ty < 5 ? ty : ty - 20;
+
+        for (int tx = 0; tx < width / 8; tx++) {
+            const int      n      = bins.count[tx];
+            const uint8_t* active = bins.list[tx];
+
+            // Tile rows for the BG and UI cell, shared by the 8 pixels
+            const __m256i row_offset = _mm256_set1_epi32((y & 7) << 2);
+            __m256i bg_row = _mm256_add_epi32(
+                _mm256_slli_epi32(gather_byte(bytes, lane_bytes, _mm256_set1_epi32(BatchData::bg_at + ty * 64 + tx)), 5),
+                row_offset);
+            __m256i ui_row_base = zero;
+            if (ui_row) {
+                ui_row_base = _mm256_add_epi32(
+                    _mm256_slli_epi32(gather_byte(bytes, lane_bytes, _mm256_set1_epi32(BatchData::ui_at + ui_ty * 40 + tx)), 5),
+                    row_offset);
+            }
+
+            for (int px = 0; px < 8; px++) {
+                const int     x     = tx * 8 + px;
+                const int     shift = (x & 1) ? 0 : 4;
+                const __m256i X     = _mm256_set1_epi32(x);
+                const __m256i half  = _mm256_set1_epi32(px >> 1);
+
+                // Background
+                __m256i b   = gather_byte(bytes, lane_bytes, _mm256_add_epi32(bg_row, half));
+                __m256i val = _mm256_and_si256(_mm256_srli_epi32(b, shift), nibble_mask);
+                __m256i rgb = _mm256_i32gather_epi32(palette, _mm256_add_epi32(lane_palette, val), 4);
+                rgb = _mm256_blendv_epi8(rgb, sky, _mm256_cmpeq_epi32(val, zero));
+
+                // Objects; lanes whose object doesn't cover this pixel are masked
+                __m256i next_lx = lx, next_ly = ly;
+                const __m256i obj_row   = _mm256_add_epi32(_mm256_slli_epi32(ly, 2), _mm256_srli_epi32(lx, 1));
+                const __m256i obj_shift = _mm256_slli_epi32(_mm256_andnot_si256(lx, _mm256_set1_epi32(1)), 2);
+                const __m256i obj_pal   = _mm256_add_epi32(lane_palette, _mm256_slli_epi32(pal, 4));
+                for (int k = 0; k < n; k++) {
+                    const int i = active[k];
+                    __m256i ox  = load_lanes(d.x[i]);
+                    __m256i oy  = load_lanes(d.y[i]);
+                    __m256i hit = _mm256_and_si256(load_lanes(d.enabled[i]), _mm256_cmpgt_epi32(load_lanes(d.x_end[i]), X));
+                    hit = _mm256_andnot_si256(_mm256_cmpgt_epi32(ox, X), hit);
+                    hit = _mm256_and_si256(hit, _mm256_cmpgt_epi32(load_lanes(d.y_end[i]), Y));
+                    hit = _mm256_andnot_si256(_mm256_cmpgt_epi32(oy, Y), hit);
+                    if (_mm256_testz_si256(hit, hit)) continue;
+
+                    __m256i cand_lx = _mm256_blendv_epi8(_mm256_and_si256(_mm256_sub_epi32(X, ox), seven),
+                                                         _mm256_sub_epi32(seven, lx), load_lanes(d.hflip[i]));
+                    __m256i cand_ly = _mm256_blendv_epi8(_mm256_and_si256(_mm256_sub_epi32(Y, oy), seven),
+                                                         _mm256_sub_epi32(seven, ly), load_lanes(d.vflip[i]));
+                    next_lx = _mm256_blendv_epi8(next_lx, cand_lx, hit);
+                    next_ly = _mm256_blendv_epi8(next_ly, cand_ly, hit);
+
+                    __m256i offset = _mm256_and_si256(_mm256_add_epi32(load_lanes(d.tile_base[i]), obj_row),
+                                                      _mm256_set1_epi32(0x1FFF));
+                    __m256i data   = _mm256_and_si256(_mm256_srlv_epi32(gather_byte(bytes, lane_bytes, offset), obj_shift),
+                                                      nibble_mask);
+                    __m256i opaque = _mm256_andnot_si256(_mm256_cmpeq_epi32(data, nibble_mask), hit);
+                    __m256i color  = _mm256_i32gather_epi32(palette, _mm256_add_epi32(obj_pal, data), 4);
+                    rgb = _mm256_blendv_epi8(rgb, color, opaque);
+                }
+
+                // UI bars
+                if (ui_row) {
+                    __m256i ub  = gather_byte(bytes, lane_bytes, _mm256_add_epi32(ui_row_base, half));
+                    __m256i uv  = _mm256_and_si256(_mm256_srli_epi32(ub, shift), nibble_mask);
+                    __m256i col = _mm256_i32gather_epi32(palette, _mm256_add_epi32(lane_palette, uv), 4);
+                    rgb = _mm256_blendv_epi8(col, rgb, _mm256_cmpeq_epi32(uv, zero));
+                }
+
+                group[px] = rgb;
+                lx  = next_lx;
+                ly  = next_ly;
+                pal = _mm256_blendv_epi8(pal, last_palette, any_enabled);
+            }
+
+            // [pixel][lane] -> [lane][pixel]: 8 consecutive pixels per scene
+            transpose8(group);
+            const std::size_t at = (static_cast<std::size_t>(y) * width + tx * 8) * 4;
+            for (int l = 0; l < count; l++) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba[l] + at), group[l]);
+            }
+        }
+    }
+
+    alignas(32) int32_t final_state[3][batch_lanes];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(final_state[0]), lx);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(final_state[1]), ly);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(final_state[2]), pal);
+    for (int l = 0; l < count; l++) {
+        state[l].local_x     = static_cast<uint8_t>(final_state[0][l]);
+        state[l].local_y     = static_cast<uint8_t>(final_state[1][l]);
+        state[l].palette_idx = static_cast<uint8_t>(final_state[2][l]);
+        advance_animation(*vram[l], state[l]);
+    }
+}
+
+#endif // MUD16_SOFT_RENDER_AVX2
+
+bool batch_uses_simd() {
+#ifdef MUD16_SOFT_RENDER_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+#else
+    return false;
+#endif
+}
+
+void render_batch(const Vram* const* vram, State* state, uint8_t* const* rgba, int count) {
+    count = std::min(std::max(count, 0), batch_lanes);
+    if (!count) return;
+
+#ifdef MUD16_SOFT_RENDER_AVX2
+    // The SIMD path shares tile-row fetches across 8-pixel columns, which
+    // only line up when no scene is finely scrolled
+    bool aligned = true;
+    for (int l = 0; l < count; l++) aligned = aligned && !vram[l]->regs.fine_x() && !vram[l]->regs.fine_y();
+
+    if (batch_uses_simd() && aligned) {
+        thread_local std::unique_ptr<BatchData> data(new BatchData);
+        pack(*data, vram, state, count);
+        render_avx2(*data, vram, state, rgba, count);
+        return;
+    }
+#endif
+    for (int l = 0; l < count; l++) render(*vram[l], state[l], rgba[l]);
+}
+
+} // namespace soft_render
@@ -0,0 +1,331 @@
+// Verilator testbench top: the PPU together with the shared SRAM, the 68000
+// bus arbitration stand-in and a framebuffer, so the C++ side only toggles
+// the clock. Mirrors Mud16System::simulate_cpu_arbitration() and
+// simulate_memory() cycle for cycle. The display's scan, TE and tearing
+// check mirror Ili9488Panel the same way, the boot flash SpiFlash.
+//
+// Everything is on the rising edge, so one eval covers a cycle. The C++
+// model runs the stand-in between its two evals, on the outputs of the
+// rising edge it just evaluated, and the PPU sees the result at the next
+// one. Here the PPU's inputs are the combinational *_next values computed
+// from its current outputs, and the posedge block registers what the C++
+// model would have updated after that edge. The first edge only starts
+// the stand-in (there is no cycle before it to respond to), so counters
+// and the framebuffer trail the PPU by one clock; Mud16TbSystem accounts
+// for that in stats().
+module tb_top #(
+    parameter DISP_WIDTH  = 320,
+    parameter DISP_HEIGHT = 240,
+    parameter RAM_BYTES   = 512 * 1024,
+    parameter MEM_WIDTH   = 16,
+    parameter PANEL_LINE_CYCLES = 1844, // Ili9488Panel::line_cycles
+    parameter PANEL_PORCH       = 4,    // Ili9488Panel::porch_lines
+    parameter FLASH_BYTES       = 1024 * 1024
+) (
+    input  logic        clk,
+    input  logic        reset,
+    input  logic        boot_flash,
+
+    output logic [31:0] frame_count,
+    output logic [63:0] pixel_count,
+    output logic [63:0] bus_hold_cycles,
+    output logic [63:0] held_frames,
+    output logic [63:0] held_bus_hold_cycles,
+    output logic [63:0] panel_refreshes,
+    output logic [63:0] tear_events,
+    output logic [63:0] boot_cycles,
+    output logic [63:0] flash_bytes_read
+);
+
+    // Loaded from C++ through the public array (see Mud16TbSystem)
+    logic [7:0]  sram [0:RAM_BYTES-1] /*verilator public_flat_rw*/;
+    logic [23:0] fb   [0:DISP_WIDTH*DISP_HEIGHT-1] /*verilator public_flat_rw*/;
+    logic [7:0]  flash [0:FLASH_BYTES-1] /*verilator public_flat_rw*/;
+
+    logic [7:0]  pixel_r, pixel_g, pixel_b;
+    logic        pixel_sync;
+    logic        vblank;
+    logic        cpu_bg_n, cpu_as_n;
+    logic        ppu_br_n, ppu_bgack_n, cpu_bus_oe_n;
+    logic [19:0] mem_addr;
+    logic [MEM_WIDTH-1:0] mem_rdata;
+    logic [15:0] mem_wdata;
+    logic        mem_read, mem_write;
+    logic        te;
+    logic        booting;
+    logic        spi_cs_n, spi_sck, spi_mosi, spi_miso;
+
+    ppu #(
+        .DISP_WIDTH(DISP_WIDTH),
+        .DISP_HEIGHT(DISP_HEIGHT),
+        .MEM_WIDTH(MEM_WIDTH)
+    ) u_ppu (
+        .clk(clk),
+        .reset(reset),
+        .te(te),
+        .boot_flash(boot_flash),
+        .booting(booting),
+        .spi_cs_n(spi_cs_n),
+        .spi_sck(spi_sck),
+        .spi_mosi(spi_mosi),
+        .spi_miso(spi_miso),
+        .pixel_r(pixel_r),
+        .pixel_g(pixel_g),
+        .pixel_b(pixel_b),
+        .pixel_sync(pixel_sync),
+        .vblank(vblank),
+        .te_idle(),
+        .cpu_bg_n(cpu_bg_n),
+        .cpu_as_n(cpu_as_n),
+        .ppu_br_n(ppu_br_n),
+        .ppu_bgack_n(ppu_bgack_n),
+        .cpu_bus_oe_n(cpu_bus_oe_n),
+        .mem_addr(mem_addr),
+        .mem_rdata(mem_rdata),
+        .mem_wdata(mem_wdata),
+        .mem_read(mem_read),
+        .mem_write(mem_write)
+    );
+
+    // -------------------------------------------------------------------------
+    // CPU arbitration stand-in + SRAM
+    // -------------------------------------------------------------------------
+    logic        started;          // past the first edge
+    logic        reset_seen;       // reset as the C++ model saw it, one edge back
+    logic        cpu_bg_n_r, cpu_as_n_r, spi_miso_r;
+    logic [MEM_WIDTH-1:0] mem_rdata_r;
+    logic        cpu_bg_n_next, cpu_as_n_next, spi_miso_next, te_next;
+    logic [MEM_WIDTH-1:0] mem_rdata_next;
+    logic [63:0] tick_count;
+    logic [2:0]  cpu_grant_delay_counter;
+    logic [31:0] fb_cursor;
+    logic        frame_pixels;     // some pixel of the current frame came out
+    logic [63:0] frame_hold_start; // bus_hold_cycles at the last vblank
+
+    // Display scan and tearing check (Ili9488Panel)
+    logic [15:0] panel_line_cycle;
+    logic [15:0] panel_line;
+    logic [15:0] scan_row;
+    logic [31:0] scan_frame;     // frame of the rows scanned so far, 0 = none
+    logic        torn;
+    logic [31:0] row_frame [0:DISP_HEIGHT-1]; // frame id per GRAM row, 0 = never written
+    logic [15:0] wr_x, wr_row;
+    logic [31:0] wr_frame;
+
+    assign scan_row = panel_line - 16'(PANEL_PORCH);
+
+    // Boot flash (SpiFlash)
+    logic [31:0] f_cmd;
+    logic [5:0]  f_bits;
+    logic        f_reading;
+    logic [23:0] f_addr;
+    logic [2:0]  f_bit;
+    logic [7:0]  f_cur;
+    logic        f_prev_sck;
+    logic [7:0]  f_byte;
+
+    assign f_byte = 32'(f_addr) < FLASH_BYTES ? flash[f_addr[19:0]] : 8'hFF;
+
+    initial begin
+        started                 = 0;
+        reset_seen              = 1;
+        cpu_bg_n_r              = 1; // Not granted
+        cpu_as_n_r              = 1; // Address strobe inactive
+        mem_rdata_r             = 0;
+        tick_count              = 0;
+        cpu_grant_delay_counter = 0;
+        fb_cursor               = 0;
+        frame_count             = 0;
+        pixel_count             = 0;
+        bus_hold_cycles         = 0;
+        held_frames             = 0;
+        held_bus_hold_cycles    = 0;
+        frame_pixels            = 0;
+        frame_hold_start        = 0;
+        panel_line_cycle        = 0;
+        panel_line              = 0;
+        scan_frame              = 0;
+        torn                    = 0;
+        wr_x                    = 0;
+        wr_row                  = 0;
+        wr_frame                = 1;
+        panel_refreshes         = 0;
+        tear_events             = 0;
+        spi_miso_r              = 1;
+        f_cmd                   = 0;
+        f_bits                  = 0;
+        f_reading               = 0;
+        f_addr                  = 0;
+        f_bit                   = 0;
+        f_cur                   = 8'hFF;
+        f_prev_sck              = 0;
+        boot_cycles             = 0;
+        flash_bytes_read        = 0;
+        for (int r = 0; r < DISP_HEIGHT; r++) row_frame[r] = 0;
+    end
+
+    // What the PPU samples at the next edge: before the first edge the
+    // initial pin states, after it the stand-in's response to the outputs
+    // of the edge just taken
+    assign cpu_bg_n  = started ? cpu_bg_n_next : cpu_bg_n_r;
+    assign cpu_as_n  = started ? cpu_as_n_next : cpu_as_n_r;
+    assign mem_rdata = started ? mem_rdata_next : mem_rdata_r;
+    assign spi_miso  = started ? spi_miso_next : spi_miso_r;
+    assign te        = started ? te_next : 1'b0;
+
+    always_comb begin
+        // CPU takes some time to finish current instruction and release bus
+        cpu_bg_n_next = cpu_bg_n_r;
+        cpu_as_n_next = cpu_as_n_r;
+        if (!ppu_br_n) begin
+            if (cpu_grant_delay_counter >= 4) begin
+                cpu_bg_n_next = 0;
+                cpu_as_n_next = 1;
+            end
+        end else begin
+            cpu_bg_n_next = 1;
+            if (ppu_bgack_n) cpu_as_n_next = (tick_count[1:0] == 0) ? 0 : 1;
+        end
+
+        // Only respond if PPU is actually driving the bus. Reads see SRAM
+        // before this cycle's write, which lands at the next edge.
+        mem_rdata_next = mem_rdata_r;
+        if (!ppu_bgack_n && cpu_bus_oe_n) begin
+            if (mem_read && 32'(mem_addr) + MEM_WIDTH / 8 - 1 < RAM_BYTES) begin
+                // One SRAM chip, or both when MEM_WIDTH is 32
+                mem_rdata_next = MEM_WIDTH'({sram[19'(mem_addr + 3)], sram[19'(mem_addr + 2)],
+                                             sram[19'(mem_addr + 1)], sram[19'(mem_addr)]});
+            end
+        end else begin
+            mem_rdata_next = 0;
+        end
+
+        // SPI flash data, MSB first on SCK falling
+        spi_miso_next = spi_miso_r;
+        if (!spi_cs_n && !spi_sck && f_prev_sck && f_reading) begin
+            spi_miso_next = f_bit == 0 ? f_byte[7] : f_cur[3'd7 - f_bit];
+        end
+
+        // The panel's TE as of the line before this cycle's scan step
+        te_next = panel_line < 16'(PANEL_PORCH);
+    end
+
+    always_ff @(posedge clk) begin
+        started    <= 1;
+        reset_seen <= reset;
+
+        if (started) begin
+            cpu_bg_n_r  <= cpu_bg_n_next;
+            cpu_as_n_r  <= cpu_as_n_next;
+            mem_rdata_r <= mem_rdata_next;
+            spi_miso_r  <= spi_miso_next;
+
+            if (!ppu_br_n) begin
+                if (cpu_grant_delay_counter < 4) cpu_grant_delay_counter <= cpu_grant_delay_counter + 1;
+            end else begin
+                cpu_grant_delay_counter <= 0;
+            end
+
+            if (!ppu_bgack_n && cpu_bus_oe_n && mem_write && 32'(mem_addr) + 1 < RAM_BYTES) begin
+                sram[19'(mem_addr)]     <= mem_wdata[7:0];
+                sram[19'(mem_addr + 1)] <= mem_wdata[15:8];
+            end
+
+            if (!ppu_bgack_n) bus_hold_cycles <= bus_hold_cycles + 1;
+
+            // SPI flash, READ (03h) only: command and address on SCK rising,
+            // data MSB first on SCK falling
+            if (spi_cs_n) begin
+                f_bits    <= 0;
+                f_reading <= 0;
+            end else if (spi_sck && !f_prev_sck && !f_reading && f_bits < 32) begin
+                f_cmd  <= {f_cmd[30:0], spi_mosi};
+                f_bits <= f_bits + 1;
+                if (f_bits == 31) begin
+                    f_reading <= f_cmd[30:23] == 8'h03;
+                    f_addr    <= {f_cmd[22:0], spi_mosi};
+                    f_bit     <= 0;
+                end
+            end else if (!spi_sck && f_prev_sck && f_reading) begin
+                if (f_bit == 0) begin
+                    f_cur            <= f_byte;
+                    f_addr           <= f_addr + 1;
+                    flash_bytes_read <= flash_bytes_read + 1;
+                end
+                f_bit <= f_bit + 1;
+            end
+            f_prev_sck <= spi_sck;
+            if (booting) boot_cycles <= boot_cycles + 1;
+
+            // The panel scans on its own clock; the check sees GRAM as it was
+            // before this cycle's pixel, like Ili9488Panel::tick() before
+            // write_pixel()
+            if (panel_line_cycle == 0 && panel_line >= 16'(PANEL_PORCH)) begin
+                if (wr_x != 0 && wr_row == scan_row) torn <= 1;
+                if (row_frame[scan_row] != 0) begin
+                    if (scan_frame != 0 && row_frame[scan_row] != scan_frame) torn <= 1;
+                    scan_frame <= row_frame[scan_row];
+                end
+            end
+            if (panel_line_cycle == 16'(PANEL_LINE_CYCLES - 1)) begin
+                panel_line_cycle <= 0;
+                if (panel_line == 16'(DISP_HEIGHT + PANEL_PORCH - 1)) begin
+                    panel_line      <= 0;
+                    panel_refreshes <= panel_refreshes + 1;
+                    if (torn) tear_events <= tear_events + 1;
+                    scan_frame      <= 0;
+                    torn            <= 0;
+                end else begin
+                    panel_line <= panel_line + 1;
+                end
+            end else begin
+                panel_line_cycle <= panel_line_cycle + 1;
+            end
+
+            if (reset_seen) begin
+                fb_cursor <= 0;
+                wr_x      <= 0;
+                wr_row    <= 0;
+            end else if (pixel_sync) begin
+                fb[fb_cursor] <= {pixel_r, pixel_g, pixel_b};
+                pixel_count   <= pixel_count + 1;
+                frame_pixels  <= 1;
+                if (fb_cursor == DISP_WIDTH * DISP_HEIGHT - 1) begin
+                    fb_cursor   <= 0;
+                    frame_count <= frame_count + 1;
+                end else begin
+                    fb_cursor <= fb_cursor + 1;
+                end
+
+                // GRAM row complete
+                if (wr_x == 16'(DISP_WIDTH - 1)) begin
+                    wr_x              <= 0;
+                    row_frame[wr_row] <= wr_frame;
+                    if (wr_row == 16'(DISP_HEIGHT - 1)) begin
+                        wr_row   <= 0;
+                        wr_frame <= wr_frame + 1;
+                    end else begin
+                        wr_row <= wr_row + 1;
+                    end
+                end else begin
+                    wr_x <= wr_x + 1;
+                end
+            end
+
+            // A frame without pixels was held by present on demand; counted
+            // like Mud16System::end_frame(), with this cycle's hold included
+            if (vblank) begin
+                if (!frame_pixels && !pixel_sync) begin
+                    frame_count          <= frame_count + 1;
+                    held_frames          <= held_frames + 1;
+                    held_bus_hold_cycles <= held_bus_hold_cycles + bus_hold_cycles + 64'(!ppu_bgack_n) - frame_hold_start;
+                end
+                frame_pixels     <= 0;
+                frame_hold_start <= bus_hold_cycles + 64'(!ppu_bgack_n);
+            end
+
+            tick_count <= tick_count + 1;
+        end
+    end
+
+endmodule
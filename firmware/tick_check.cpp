@@ -0,0 +1,46 @@
+#include "tick_check.h"
+#include "frame_hash.h"
+
+namespace tick_check {
+
+static uint64_t hash_frame(const Mud16System& sys) {
+    return frame_hash::hash64(sys.framebuffer(),
+                              static_cast<std::size_t>(Mud16System::width) * Mud16System::height * 4);
+}
+
+Result run(const std::vector<uint8_t>& ram, uint32_t frames, const CpuBusConfig& cpu) {
+    Result r;
+    r.supported = Mud16System::fast_tick_supported();
+    if (!r.supported) return r;
+
+    Mud16System full, fast;
+    for (Mud16System* sys : {&full, &fast}) {
+        sys->load_image(ram.data(), ram.size());
+        sys->configure_cpu(cpu);
+    }
+    fast.set_fast_tick(true);
+    full.reset();
+    fast.reset();
+
+    for (uint32_t f = 0; f < frames; f++) {
+        full.step_frames(1);
+        fast.step_frames(1);
+
+        Mud16Stats a = full.stats();
+        Mud16Stats b = fast.stats();
+        r.hash_full = hash_frame(full);
+        r.hash_fast = hash_frame(fast);
+        r.frames_checked = f + 1;
+
+        if (r.hash_full != r.hash_fast || a.cycles != b.cycles ||
+            a.bus_hold_cycles != b.bus_hold_cycles) {
+            r.first_mismatch = f;
+            return r;
+        }
+    }
+
+    r.ok = true;
+    return r;
+}
+
+} // namespace tick_check
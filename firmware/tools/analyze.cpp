@@ -0,0 +1,93 @@
+//
+// mud16_analyze: tile and VRAM usage report
+//
+// Feeds RAM images, or the RAM of a running Mud16System after every frame,
+// to vram_analyzer::Analyzer and prints which tiles, palettes and map cells
+// are referenced, duplicate tiles, and how much of each refresh never
+// reaches the screen. A list of images is treated as a frame sequence.
+//
+// usage: mud16_analyze [--scene demo|stress|world|<ram image>]... [--simulate N] [--frame-cache]
+//
+
+#include "vram_analyzer.h"
+#include "mud16_system.h"
+#include "vram_init_data.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static bool build_scene(const std::string& scene, std::vector<uint8_t>& ram) {
+    ram.assign(Mud16System::ram_size, 0);
+
+    if (scene == "demo") {
+        vram_init::load(ram);
+    } else if (scene == "stress") {
+        vram_init::load_stress(ram);
+    } else if (scene == "world") {
+        vram_init::load_world(ram, 500, 5);
+    } else {
+        std::ifstream in(scene, std::ios::binary);
+        if (!in) return false;
+        std::vector<uint8_t> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (image.size() > ram.size()) image.resize(ram.size());
+        std::copy(image.begin(), image.end(), ram.begin());
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> scenes;
+    uint32_t simulate    = 0;
+    bool     frame_cache = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_arg = i + 1 < argc;
+        if (a == "--scene" && has_arg) {
+            scenes.push_back(argv[++i]);
+        } else if (a == "--simulate" && has_arg) {
+            simulate = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (a == "--frame-cache") {
+            frame_cache = true;
+        } else {
+            std::fprintf(stderr, "usage: mud16_analyze [--scene demo|stress|world|<ram image>]... [--simulate N] [--frame-cache]\n");
+            return 2;
+        }
+    }
+    if (scenes.empty()) scenes.push_back("demo");
+
+    vram_analyzer::Analyzer analyzer;
+    auto t0 = std::chrono::steady_clock::now();
+
+    std::vector<uint8_t> ram;
+    for (const std::string& scene : scenes) {
+        if (!build_scene(scene, ram)) {
+            std::fprintf(stderr, "cannot load scene %s\n", scene.c_str());
+            return 2;
+        }
+        if (!simulate) {
+            analyzer.observe(ram.data(), ram.size());
+            continue;
+        }
+
+        Mud16System sys;
+        sys.load_image(ram.data(), ram.size());
+        sys.set_frame_cache(frame_cache);
+        sys.reset();
+        for (uint32_t f = 0; f < simulate; f++) {
+            sys.step_frames(1);
+            analyzer.observe(sys.ram.data(), sys.ram.size());
+        }
+    }
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    analyzer.report().print(stdout);
+    std::printf("\n%.2f s\n", secs);
+    return 0;
+}
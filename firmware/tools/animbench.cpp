@@ -0,0 +1,149 @@
+//
+// mud16_animbench: CPU-driven vs PPU-driven sprite animation
+//
+// Runs the enemies scene (128 animated sprites, vram_init::load_enemies)
+// twice on Mud16System:
+//
+//   cpu  the game animates: every frame it steps each sprite's animation
+//        and rewrites the tile bits of the OAM words whose frame changed
+//   ppu  CTRL_SPRITE_ANIM is set once and the PPU steps the descriptors
+//
+// The frames of both runs must be identical. Prints what each costs: CPU
+// sprite updates and OAM writes per frame, and PPU bus hold per frame.
+//
+// usage: mud16_animbench [--frames N]
+//
+
+#include "mud16_system.h"
+#include "vram_init_data.h"
+#include "ppu_regs.h"
+#include "frame_hash.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using vram_init::Layout;
+
+struct RunResult {
+    std::vector<uint64_t> hashes;      // per frame
+    Mud16Stats            stats;
+    uint64_t              cpu_updates = 0; // sprite animation steps done by the CPU
+    uint64_t              cpu_writes  = 0; // 16-bit OAM words the CPU wrote
+    double                seconds     = 0.0;
+};
+
+// The game's side of the cpu run: the same rule the PPU applies at vblank
+struct CpuAnimator {
+    uint8_t seen[128]  = {};
+    uint8_t step[128]  = {};
+    uint8_t frame[128] = {};
+    uint16_t base_tile[128];
+
+    void init(const std::vector<uint8_t>& ram) {
+        for (int i = 0; i < 128; i++) {
+            uint32_t hi  = ram[Layout::oam_base + i * 4 + 2] | ram[Layout::oam_base + i * 4 + 3] << 8;
+            base_tile[i] = static_cast<uint16_t>((hi >> 1) & 0x1FF);
+        }
+    }
+
+    // After a frame: advance and write back the OAM words whose frame changed
+    void vblank(Mud16System& sys, RunResult& r) {
+        for (int i = 0; i < 128; i++) {
+            const uint8_t desc = sys.ram[Layout::anim_base + i];
+            const uint8_t before = frame[i];
+            if (desc != seen[i]) {
+                seen[i] = desc;
+                step[i] = frame[i] = 0;
+            } else if (step[i] != desc >> 3) {
+                step[i]++;
+            } else {
+                step[i]  = 0;
+                frame[i] = frame[i] == (desc & 7) ? 0 : frame[i] + 1;
+            }
+            r.cpu_updates++;
+            if (frame[i] == before) continue;
+
+            const uint32_t addr = Layout::oam_base + i * 4 + 2;
+            uint16_t hi = static_cast<uint16_t>(sys.ram[addr] | sys.ram[addr + 1] << 8);
+            hi = static_cast<uint16_t>((hi & ~(0x1FF << 1)) | ((base_tile[i] + frame[i]) & 0x1FF) << 1);
+            const uint8_t bytes[2] = {static_cast<uint8_t>(hi), static_cast<uint8_t>(hi >> 8)};
+            sys.write_ram(addr, bytes, 2);
+            r.cpu_writes++;
+        }
+    }
+};
+
+static RunResult run(bool ppu_animates, uint32_t frames) {
+    std::vector<uint8_t> ram(Mud16System::ram_size, 0);
+    vram_init::load_enemies(ram);
+    if (ppu_animates) {
+        ppu_regs::Regs regs = ppu_regs::Regs::from_ram(ram.data(), ram.size());
+        regs.word[ppu_regs::CTRL] |= ppu_regs::CTRL_SPRITE_ANIM;
+        regs.store(ram.data(), ram.size());
+    }
+
+    Mud16System sys;
+    sys.load_image(ram.data(), ram.size());
+    sys.reset();
+
+    CpuAnimator cpu;
+    cpu.init(ram);
+
+    RunResult r;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t f = 0; f < frames; f++) {
+        sys.step_frames(1);
+        r.hashes.push_back(frame_hash::hash64(sys.framebuffer(),
+                                              static_cast<std::size_t>(Mud16System::width) * Mud16System::height * 4));
+        if (!ppu_animates) cpu.vblank(sys, r);
+    }
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    r.stats   = sys.stats();
+    return r;
+}
+
+int main(int argc, char** argv) {
+    uint32_t frames = 120;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--frames" && i + 1 < argc) {
+            frames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else {
+            std::fprintf(stderr, "usage: mud16_animbench [--frames N]\n");
+            return 2;
+        }
+    }
+    if (frames == 0) frames = 1;
+
+    const RunResult cpu = run(false, frames);
+    const RunResult ppu = run(true, frames);
+
+    uint32_t mismatch = frames;
+    for (uint32_t f = 0; f < frames && mismatch == frames; f++) {
+        if (cpu.hashes[f] != ppu.hashes[f]) mismatch = f;
+    }
+
+    auto per_frame = [&](uint64_t v) { return double(v) / frames; };
+    std::printf("%u frames, 128 animated sprites\n\n", frames);
+    std::printf("%-5s %14s %14s %12s %12s\n", "mode", "CPU steps/frm", "OAM wr/frm", "cycles/frm", "hold/frm");
+    for (auto row : {std::make_pair("cpu", &cpu), std::make_pair("ppu", &ppu)}) {
+        const RunResult& r = *row.second;
+        std::printf("%-5s %14.1f %14.1f %12.0f %12.0f\n", row.first, per_frame(r.cpu_updates), per_frame(r.cpu_writes),
+                    per_frame(r.stats.cycles), per_frame(r.stats.bus_hold_cycles));
+    }
+
+    const double hold_delta = per_frame(ppu.stats.bus_hold_cycles) - per_frame(cpu.stats.bus_hold_cycles);
+    std::printf("\nCPU saves %.1f sprite steps and %.1f OAM word writes per frame; the PPU reads the\n"
+                "descriptors in every refresh, %+.0f bus hold cycles per frame\n",
+                per_frame(cpu.cpu_updates), per_frame(cpu.cpu_writes), hold_delta);
+
+    if (mismatch != frames) {
+        std::printf("FAIL: frame %u differs between cpu and ppu animation\n", mismatch);
+        return 1;
+    }
+    std::printf("frames identical\n");
+    return 0;
+}
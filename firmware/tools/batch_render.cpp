@@ -0,0 +1,179 @@
+//
+// mud16_batch: batched software rendering of many independent scenes
+//
+// Generates seeded variations of the demo and stress scenes (OAM positions,
+// tiles, palettes and flips, palette colours), renders each for --frames
+// frames with the scalar soft_render::render() and with render_batch()
+// (8 scenes per AVX2 pass) on the same number of threads, checks both give
+// the same frames and prints scenes per second for each.
+//
+// --verify K also runs the first K scenes through Mud16System and compares
+// the last frame with the software renderer's.
+//
+// usage: mud16_batch [--scenes N] [--frames N] [--seed S] [-j N] [--verify K]
+//
+
+#include "soft_render.h"
+#include "mud16_system.h"
+#include "vram_init_data.h"
+#include "frame_hash.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr std::size_t frame_bytes = static_cast<std::size_t>(soft_render::width) * soft_render::height * 4;
+
+// xorshift64*
+static uint64_t next_random(uint64_t& s) {
+    s ^= s >> 12;
+    s ^= s << 25;
+    s ^= s >> 27;
+    return s * 0x2545F4914F6CDD1DULL;
+}
+
+static void make_scene(uint64_t seed, uint64_t index, std::vector<uint8_t>& ram) {
+    using L = vram_init::Layout;
+    uint64_t s = (seed ^ (index * 0x9E3779B97F4A7C15ULL)) | 1;
+
+    ram.assign(Mud16System::ram_size, 0);
+    if (index & 1) {
+        vram_init::load_stress(ram);
+    } else {
+        vram_init::load(ram);
+    }
+
+    // A few palette colours
+    for (int k = 0; k < 8; k++) {
+        uint32_t r = static_cast<uint32_t>(next_random(s));
+        uint32_t a = L::palette_base + (r % 128) * 2;
+        ram[a]     = static_cast<uint8_t>(r >> 8);
+        ram[a + 1] = static_cast<uint8_t>((r >> 16) & 0x0F);
+    }
+
+    // Objects: about half enabled, anywhere on screen, tiles 0-17
+    for (int i = 0; i < vram_init::Params::oam_entries; i++) {
+        uint64_t r = next_random(s);
+        uint32_t word = static_cast<uint32_t>((r >> 1) % 328)            // x
+                      | static_cast<uint32_t>((r >> 12) % 248) << 9      // y
+                      | static_cast<uint32_t>((r >> 24) % 18) << 17      // tile
+                      | static_cast<uint32_t>((r >> 32) & 0x3) << 26     // palette 0-3
+                      | static_cast<uint32_t>((r >> 34) & 0x3) << 29     // hflip, vflip
+                      | static_cast<uint32_t>((r >> 36) & 0x1) << 31;    // enable
+        for (int b = 0; b < 4; b++) ram[L::oam_base + i * 4 + b] = static_cast<uint8_t>(word >> (8 * b));
+    }
+}
+
+template <class Fn>
+static double run_parallel(unsigned jobs, std::size_t items, Fn fn) {
+    std::atomic<std::size_t> next{0};
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < jobs; ++w) {
+        workers.emplace_back([&]() {
+            for (std::size_t i = next++; i < items; i = next++) fn(i);
+        });
+    }
+    for (auto& t : workers) t.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    std::size_t scenes = 2048;
+    uint32_t    frames = 1;
+    uint64_t    seed   = 1;
+    unsigned    jobs   = 0;
+    std::size_t verify = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_arg = i + 1 < argc;
+        if (a == "--scenes" && has_arg) {
+            scenes = std::strtoull(argv[++i], nullptr, 0);
+        } else if (a == "--frames" && has_arg) {
+            frames = std::max(1u, static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0)));
+        } else if (a == "--seed" && has_arg) {
+            seed = std::strtoull(argv[++i], nullptr, 0);
+        } else if (a == "-j" && has_arg) {
+            jobs = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (a == "--verify" && has_arg) {
+            verify = std::strtoull(argv[++i], nullptr, 0);
+        } else {
+            std::fprintf(stderr, "usage: mud16_batch [--scenes N] [--frames N] [--seed S] [-j N] [--verify K]\n");
+            return 2;
+        }
+    }
+    if (!jobs) jobs = std::max(1u, std::thread::hardware_concurrency());
+    verify = std::min(verify, scenes);
+
+    std::vector<soft_render::Vram> vram(scenes);
+    run_parallel(jobs, scenes, [&](std::size_t i) {
+        std::vector<uint8_t> ram;
+        make_scene(seed, i, ram);
+        soft_render::Vram::from_ram(ram.data(), ram.size(), vram[i]);
+    });
+
+    // Scalar: one scene per task
+    std::vector<uint64_t> scalar_hash(scenes);
+    double scalar_secs = run_parallel(jobs, scenes, [&](std::size_t i) {
+        std::vector<uint8_t> rgba(frame_bytes);
+        soft_render::State state;
+        for (uint32_t f = 0; f < frames; f++) soft_render::render(vram[i], state, rgba.data());
+        scalar_hash[i] = frame_hash::hash64(rgba.data(), rgba.size());
+    });
+
+    // Batched: batch_lanes scenes per task
+    const std::size_t lanes   = soft_render::batch_lanes;
+    const std::size_t batches = (scenes + lanes - 1) / lanes;
+    std::vector<uint64_t> batch_hash(scenes);
+    double batch_secs = run_parallel(jobs, batches, [&](std::size_t b) {
+        const std::size_t first = b * lanes;
+        const int count = static_cast<int>(std::min(lanes, scenes - first));
+
+        std::vector<uint8_t> rgba(frame_bytes * lanes);
+        const soft_render::Vram* in[soft_render::batch_lanes];
+        uint8_t*                 out[soft_render::batch_lanes];
+        soft_render::State       state[soft_render::batch_lanes];
+        for (int l = 0; l < count; l++) {
+            in[l]  = &vram[first + l];
+            out[l] = rgba.data() + l * frame_bytes;
+        }
+        for (uint32_t f = 0; f < frames; f++) soft_render::render_batch(in, state, out, count);
+        for (int l = 0; l < count; l++) batch_hash[first + l] = frame_hash::hash64(out[l], frame_bytes);
+    });
+
+    std::size_t differ = 0;
+    for (std::size_t i = 0; i < scenes; i++) differ += scalar_hash[i] != batch_hash[i];
+
+    std::printf("%zu scenes, %u frame(s) each, %u threads, batch %s\n", scenes, frames, jobs,
+                soft_render::batch_uses_simd() ? "AVX2 x8" : "scalar fallback");
+    std::printf("scalar   %9.1f scenes/s\n", scalar_secs > 0 ? scenes / scalar_secs : 0.0);
+    std::printf("batch    %9.1f scenes/s (%.2fx)\n", batch_secs > 0 ? scenes / batch_secs : 0.0,
+                batch_secs > 0 ? scalar_secs / batch_secs : 0.0);
+    std::printf("batch vs scalar: %zu differing frames\n", differ);
+
+    std::size_t sim_differ = 0;
+    if (verify) {
+        std::atomic<std::size_t> bad{0};
+        run_parallel(jobs, verify, [&](std::size_t i) {
+            std::vector<uint8_t> ram;
+            make_scene(seed, i, ram);
+            Mud16System sys;
+            sys.load_image(ram.data(), ram.size());
+            sys.reset();
+            sys.step_frames(frames);
+            if (frame_hash::hash64(sys.framebuffer(), frame_bytes) != scalar_hash[i]) {
+                bad++;
+                std::printf("scene %zu: simulation differs\n", i);
+            }
+        });
+        sim_differ = bad;
+        std::printf("simulation vs soft render: %zu of %zu differ\n", sim_differ, verify);
+    }
+    return differ || sim_differ ? 1 : 0;
+}
@@ -0,0 +1,334 @@
+//
+// mud16_bench: headless simulation benchmark
+//
+// Runs a scene for a fixed number of frames and prints simulation speed and
+// bus statistics. Also the workload for the profiling and PGO builds.
+//
+// --model cpp   Mud16System: SRAM and CPU stand-in in C++ (default)
+// --model tb    Mud16TbSystem: SRAM and CPU stand-in inside tb_top.sv
+// --model both  runs both and checks they produce the same frames
+//
+// --tick fast runs Mud16System with one eval per cycle. The scene is first
+// checked against the normal mode for --validate frames (see tick_check.h);
+// on any difference the fast mode is refused and the normal one is used.
+//
+// --frame-cache reuses frames while VRAM is unchanged (Mud16System only);
+// --touch N moves sprite 0 every N frames so there is something to miss on.
+//
+// --present N turns on present on demand (CTRL_PRESENT) and has the CPU
+// present a new frame every N frames; the others are held. Prints the
+// frames sent to the display and an estimate of the energy saved.
+//
+// --te-sync starts every frame at the display's TE (CTRL_TE_SYNC). Either
+// way the display's refreshes that showed parts of two frames are counted
+// and reported as tearing events per second of simulated time.
+//
+// --idle-skip jumps over the cycles the PPU only waits for TE (Mud16System
+// only, see set_idle_skip()) and prints the fraction of cycles skipped.
+//
+// --flash boots from a flash image instead of loading the scene into RAM:
+// a file from mud16_mkflash, or plain / lz to build one from the scene.
+// RAM starts cleared; prints the boot time and the flash bytes read, and
+// checks RAM against the image right after the boot.
+//
+// usage: mud16_bench [--scene demo|stress|world|<ram image>] [--frames N] [--model cpp|tb|both]
+//                    [--tick full|fast] [--validate N] [--frame-cache] [--touch N] [--present N]
+//                    [--te-sync] [--idle-skip] [--flash <image>|plain|lz]
+//
+
+#include "mud16_system.h"
+#include "mud16_tb_system.h"
+#include "boot_image.h"
+#include "ppu_regs.h"
+#include "vram_init_data.h"
+#include "frame_hash.h"
+#include "tick_check.h"
+#include "frame_budget.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+struct BenchResult {
+    Mud16Stats stats;
+    double     seconds    = 0.0;
+    uint64_t   frame_hash = 0;
+    bool       boot_ok    = false; // RAM matched the flash image after the boot
+};
+
+static bool build_scene(const std::string& scene, std::vector<uint8_t>& ram) {
+    ram.assign(Mud16System::ram_size, 0);
+
+    if (scene == "demo") {
+        vram_init::load(ram);
+    } else if (scene == "stress") {
+        vram_init::load_stress(ram);
+    } else if (scene == "world") {
+        vram_init::load_world(ram, 500, 5);
+    } else {
+        std::ifstream in(scene, std::ios::binary);
+        if (!in) return false;
+        std::vector<uint8_t> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (image.size() > ram.size()) image.resize(ram.size());
+        std::copy(image.begin(), image.end(), ram.begin());
+    }
+    return true;
+}
+
+struct RunOptions {
+    uint32_t frames      = 60;
+    bool     fast_tick   = false;
+    bool     frame_cache = false;
+    uint32_t touch       = 0;
+    uint32_t present     = 0;
+    bool     idle_skip   = false;
+
+    // Boot image; RAM starts cleared and `boot_ram` is what the boot has to
+    // leave in it
+    std::vector<uint8_t> flash;
+    std::vector<uint8_t> boot_ram;
+};
+
+// What the game does once the next frame is complete
+template <class System>
+static void present_next(System& sys) {
+    const uint32_t addr = vram_init::Layout::reg_base + ppu_regs::PRESENT * 2;
+    uint8_t        w[2] = {};
+    sys.read_ram(addr, w, 2);
+    const uint16_t next = static_cast<uint16_t>((w[0] | w[1] << 8) + 1);
+    w[0] = static_cast<uint8_t>(next);
+    w[1] = static_cast<uint8_t>(next >> 8);
+    sys.write_ram(addr, w, 2);
+}
+
+// Fast tick and the frame cache only exist for the C++-driven system
+static void configure(Mud16System& sys, const RunOptions& opt) {
+    if (opt.fast_tick) sys.set_fast_tick(true);
+    sys.set_frame_cache(opt.frame_cache);
+    sys.set_idle_skip(opt.idle_skip);
+}
+static void configure(Mud16TbSystem&, const RunOptions&) {}
+
+template <class System>
+static BenchResult run(const std::vector<uint8_t>& ram, const RunOptions& opt) {
+    System sys;
+    BenchResult r;
+    if (opt.flash.empty()) {
+        sys.load_image(ram.data(), ram.size());
+    } else {
+        const std::vector<uint8_t> cleared(ram.size(), 0);
+        sys.load_image(cleared.data(), cleared.size());
+        sys.load_flash(opt.flash.data(), opt.flash.size());
+    }
+    configure(sys, opt);
+
+    auto t0 = std::chrono::steady_clock::now();
+    sys.reset();
+    if (!opt.flash.empty()) {
+        // The boot counter stops with the boot
+        uint64_t booted = 0;
+        do {
+            booted = sys.stats().boot_cycles;
+            sys.step_cycles(1);
+        } while (sys.stats().boot_cycles != booted);
+
+        std::vector<uint8_t> now(ram.size());
+        sys.read_ram(0, now.data(), now.size());
+        r.boot_ok = now == opt.boot_ram;
+    }
+    if (opt.touch || opt.present) {
+        for (uint32_t f = 0; f < opt.frames; f++) {
+            if (opt.touch && f % opt.touch == 0) {
+                // Low byte of sprite 0's x position
+                uint8_t x = static_cast<uint8_t>(f / opt.touch * 3);
+                sys.write_ram(vram_init::Layout::oam_base, &x, 1);
+            }
+            if (opt.present && f % opt.present == 0) present_next(sys);
+            sys.step_frames(1);
+        }
+    } else {
+        sys.step_frames(opt.frames);
+    }
+
+    r.seconds    = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    r.stats      = sys.stats();
+    r.frame_hash = frame_hash::hash64(sys.framebuffer(), static_cast<std::size_t>(System::width) * System::height * 4);
+    return r;
+}
+
+static double mcycles_per_sec(const BenchResult& r) {
+    return r.seconds > 0 ? r.stats.cycles / 1e6 / r.seconds : 0.0;
+}
+
+// Energy estimate for present on demand. Counts activity, not joules: a
+// presented frame costs its render cycles, one LCD write per pixel and its
+// bus hold; a held frame only the bus hold of the register reads. Held
+// frames are compared with the average presented one.
+static void print_present(const BenchResult& r) {
+    const Mud16Stats& st        = r.stats;
+    const uint64_t    pixels    = static_cast<uint64_t>(Mud16System::width) * Mud16System::height;
+    const uint64_t    presented = st.frames - st.held_frames;
+    std::printf("present          %llu of %llu frames sent to the display, %llu held\n",
+                static_cast<unsigned long long>(presented), static_cast<unsigned long long>(st.frames),
+                static_cast<unsigned long long>(st.held_frames));
+    if (!presented) return;
+
+    const double per_presented = 2.0 * pixels + double(st.bus_hold_cycles - st.held_bus_hold_cycles) / presented;
+    const double actual        = presented * per_presented + double(st.held_bus_hold_cycles);
+    const double baseline      = st.frames * per_presented;
+    std::printf("energy saved     ~%.1f%% (estimate: render cycles, LCD writes, bus hold)\n",
+                100.0 * (1.0 - actual / baseline));
+}
+
+static void print_result(const char* model, const BenchResult& r) {
+    const Mud16Stats& st = r.stats;
+    std::printf("model            %s\n", model);
+    if (st.boot_cycles) {
+        std::printf("boot             %llu cycles (%.2f ms at 27 MHz), %llu flash bytes read, RAM %s\n",
+                    static_cast<unsigned long long>(st.boot_cycles),
+                    st.boot_cycles / frame_budget::Config{}.clock_hz * 1e3,
+                    static_cast<unsigned long long>(st.flash_bytes_read), r.boot_ok ? "ok" : "MISMATCH");
+    }
+    std::printf("frames           %llu\n", static_cast<unsigned long long>(st.frames));
+    std::printf("cycles           %llu\n", static_cast<unsigned long long>(st.cycles));
+    std::printf("cycles/frame     %.0f\n", st.frames ? double(st.cycles) / st.frames : 0.0);
+    std::printf("bus hold/frame   %.0f\n", st.frames ? double(st.bus_hold_cycles) / st.frames : 0.0);
+    std::printf("wall time        %.3f s\n", r.seconds);
+    std::printf("speed            %.2f Mcycles/s, %.1f fps\n", mcycles_per_sec(r),
+                r.seconds > 0 ? st.frames / r.seconds : 0.0);
+    if (st.cached_frames) {
+        std::printf("frame cache      %llu/%llu frames reused (%.1f%%), %.1f effective fps\n",
+                    static_cast<unsigned long long>(st.cached_frames), static_cast<unsigned long long>(st.frames),
+                    st.frames ? 100.0 * st.cached_frames / st.frames : 0.0,
+                    r.seconds > 0 ? st.frames / r.seconds : 0.0);
+    }
+    if (st.held_frames) print_present(r);
+    if (st.idle_skipped_cycles) {
+        std::printf("idle skip        %llu cycles waiting for TE skipped (%.1f%%)\n",
+                    static_cast<unsigned long long>(st.idle_skipped_cycles),
+                    st.cycles ? 100.0 * st.idle_skipped_cycles / st.cycles : 0.0);
+    }
+    const double sim_seconds = st.cycles / frame_budget::Config{}.clock_hz;
+    std::printf("tearing          %llu of %llu panel refreshes, %.1f/s\n",
+                static_cast<unsigned long long>(st.tear_events), static_cast<unsigned long long>(st.panel_refreshes),
+                sim_seconds > 0 ? st.tear_events / sim_seconds : 0.0);
+    std::printf("last frame hash  %016llx\n", static_cast<unsigned long long>(r.frame_hash));
+}
+
+int main(int argc, char** argv) {
+    std::string scene  = "demo";
+    std::string model    = "cpp";
+    std::string tick     = "full";
+    uint32_t    validate = 600;
+    RunOptions  opt;
+    bool        te_sync  = false;
+    std::string flash;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--scene" && i + 1 < argc) {
+            scene = argv[++i];
+        } else if (a == "--frames" && i + 1 < argc) {
+            opt.frames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (a == "--model" && i + 1 < argc) {
+            model = argv[++i];
+        } else if (a == "--tick" && i + 1 < argc) {
+            tick = argv[++i];
+        } else if (a == "--validate" && i + 1 < argc) {
+            validate = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (a == "--frame-cache") {
+            opt.frame_cache = true;
+        } else if (a == "--touch" && i + 1 < argc) {
+            opt.touch = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (a == "--present" && i + 1 < argc) {
+            opt.present = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (a == "--te-sync") {
+            te_sync = true;
+        } else if (a == "--idle-skip") {
+            opt.idle_skip = true;
+        } else if (a == "--flash" && i + 1 < argc) {
+            flash = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: mud16_bench [--scene demo|stress|world|<ram image>] [--frames N] [--model cpp|tb|both]\n"
+                                 "                   [--tick full|fast] [--validate N] [--frame-cache] [--touch N]\n"
+                                 "                   [--present N] [--te-sync] [--idle-skip] [--flash <image>|plain|lz]\n");
+            return 2;
+        }
+    }
+    if (tick != "full" && tick != "fast") {
+        std::fprintf(stderr, "unknown tick mode %s\n", tick.c_str());
+        return 2;
+    }
+    if (model != "cpp" && model != "tb" && model != "both") {
+        std::fprintf(stderr, "unknown model %s\n", model.c_str());
+        return 2;
+    }
+
+    std::vector<uint8_t> ram;
+    if (!build_scene(scene, ram)) {
+        std::fprintf(stderr, "cannot load scene %s\n", scene.c_str());
+        return 2;
+    }
+
+    if (opt.present) vram_init::enable_present_on_demand(ram);
+    if (te_sync) vram_init::enable_te_sync(ram);
+
+    if (flash == "plain" || flash == "lz") {
+        opt.flash = boot_image::build(boot_image::from_ram(ram.data(), ram.size()), flash == "lz");
+    } else if (!flash.empty()) {
+        std::ifstream in(flash, std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "cannot load flash image %s\n", flash.c_str());
+            return 2;
+        }
+        opt.flash.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    if (!opt.flash.empty()) {
+        opt.boot_ram.assign(ram.size(), 0);
+        if (opt.flash.size() > SpiFlash::capacity ||
+            !boot_image::load(opt.flash.data(), opt.flash.size(), opt.boot_ram.data(), opt.boot_ram.size())) {
+            std::fprintf(stderr, "bad flash image %s\n", flash.c_str());
+            return 2;
+        }
+    }
+
+    std::printf("scene            %s\n", scene.c_str());
+
+    if (tick == "fast" && model != "tb") {
+        tick_check::Result check = tick_check::run(ram, validate);
+        if (!check.supported) {
+            std::printf("tick             full (fast tick not supported by this model)\n");
+        } else if (!check.ok) {
+            std::printf("tick             full (fast tick REFUSED: frame %u differs)\n", check.first_mismatch);
+        } else {
+            std::printf("tick             fast (validated over %u frames)\n", check.frames_checked);
+            opt.fast_tick = true;
+        }
+    }
+
+    BenchResult cpp, tb;
+    if (model != "tb") {
+        cpp = run<Mud16System>(ram, opt);
+        print_result("cpp", cpp);
+    }
+    if (model != "cpp") {
+        tb = run<Mud16TbSystem>(ram, opt);
+        print_result("tb", tb);
+    }
+
+    if (model == "both") {
+        bool same = cpp.frame_hash == tb.frame_hash && cpp.stats.cycles == tb.stats.cycles &&
+                    cpp.stats.held_frames == tb.stats.held_frames && cpp.stats.tear_events == tb.stats.tear_events &&
+                    cpp.stats.boot_cycles == tb.stats.boot_cycles;
+        std::printf("tb vs cpp        %.2fx speed, %s\n",
+                    mcycles_per_sec(cpp) > 0 ? mcycles_per_sec(tb) / mcycles_per_sec(cpp) : 0.0,
+                    same ? "identical frames" : "MISMATCH");
+        return same ? 0 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+//
+// mud16_budget: analytic frame budget, cross-checked by simulation
+//
+// Estimates refresh bus hold, render cycles and the CPU's bus share for a
+// PPU configuration (see frame_budget.h) against the clock / frame-rate
+// budget, then runs every linked PPU variant (MUD16_PPU_VARIANTS) with the
+// same parameters for a few frames and reports the model's drift from the
+// simulated cycles/frame and hold/frame. Drift above --tolerance fails.
+//
+// Without parameters every linked variant is estimated and checked.
+//
+// --world, --remap and --anim estimate world map mode, the tile remap table
+// and sprite animation, and turn them on in the simulated scene.
+//
+// usage: mud16_budget [--params NAME=v,...] [--world] [--remap] [--anim] [--clock HZ]
+//                     [--rate FPS] [--frames N] [--tolerance PCT] [--no-sim]
+//
+
+#include "frame_budget.h"
+#include "mud16_variants.h"
+#include "vram_init_data.h"
+#include "ppu_regs.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+struct Check {
+    const mud16_variants::Variant* variant;
+    frame_budget::Config           config;
+};
+
+static bool same_config(const frame_budget::Config& a, const frame_budget::Config& b) {
+    return a.width == b.width && a.height == b.height && a.max_objects == b.max_objects &&
+           a.bus_read_latency == b.bus_read_latency && a.mem_width == b.mem_width;
+}
+
+// Steady-state cycles and hold per frame; the first frame after reset has
+// no overlapped refresh ahead of it, so it is run separately and subtracted
+static void simulate(const mud16_variants::Variant& v, const std::vector<uint8_t>& ram, uint32_t frames,
+                     double& cycles, double& hold) {
+    const mud16_variants::Result first = v.run(ram, 1);
+    const mud16_variants::Result all   = v.run(ram, frames + 1);
+    cycles = double(all.stats.cycles - first.stats.cycles) / frames;
+    hold   = double(all.stats.bus_hold_cycles - first.stats.bus_hold_cycles) / frames;
+}
+
+int main(int argc, char** argv) {
+    frame_budget::Config config;
+    bool     explicit_params = false;
+    bool     run_sim         = true;
+    uint32_t frames          = 3;
+    double   tolerance       = 1.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_arg = i + 1 < argc;
+        if (a == "--params" && has_arg) {
+            if (!config.apply(argv[++i])) {
+                std::fprintf(stderr, "bad --params %s\n", argv[i]);
+                return 2;
+            }
+            explicit_params = true;
+        } else if (a == "--clock" && has_arg) {
+            config.clock_hz = std::strtod(argv[++i], nullptr);
+        } else if (a == "--rate" && has_arg) {
+            config.frame_rate = std::strtod(argv[++i], nullptr);
+        } else if (a == "--frames" && has_arg) {
+            frames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (a == "--tolerance" && has_arg) {
+            tolerance = std::strtod(argv[++i], nullptr);
+        } else if (a == "--world") {
+            config.world_map = true;
+        } else if (a == "--remap") {
+            config.tile_remap = true;
+        } else if (a == "--anim") {
+            config.sprite_anim = true;
+        } else if (a == "--no-sim") {
+            run_sim = false;
+        } else {
+            std::fprintf(stderr, "usage: mud16_budget [--params NAME=v,...] [--world] [--remap] [--anim] [--clock HZ]\n"
+                                 "                    [--rate FPS] [--frames N] [--tolerance PCT] [--no-sim]\n");
+            return 2;
+        }
+    }
+    if (frames == 0) frames = 1;
+
+    std::vector<Check> checks;
+    for (const auto& v : mud16_variants::all()) {
+        frame_budget::Config vc = config;
+        vc.apply(v.params);
+        if (!explicit_params || same_config(vc, config)) checks.push_back({&v, vc});
+    }
+
+    if (explicit_params || checks.empty()) {
+        std::printf("params %s\n", explicit_params ? "(as given)" : "(ppu.sv defaults)");
+        frame_budget::estimate(config).print(stdout);
+        std::printf("\n");
+        if (checks.empty() && run_sim) {
+            std::printf("no linked PPU variant has these parameters, add one to MUD16_PPU_VARIANTS to check them\n");
+            return 0;
+        }
+    }
+
+    std::vector<uint8_t> ram(Mud16System::ram_size, 0);
+    if (config.world_map) {
+        vram_init::load_world(ram);
+    } else {
+        vram_init::load(ram);
+    }
+    if (config.tile_remap) vram_init::enable_tile_remap(ram);
+    if (config.sprite_anim) vram_init::enable_sprite_anim(ram, ppu_regs::anim_desc(2, 8));
+
+    int drifted = 0;
+    for (const Check& c : checks) {
+        const frame_budget::Estimate e = frame_budget::estimate(c.config);
+        if (!explicit_params) {
+            std::printf("variant %s %s\n", c.variant->name, *c.variant->params ? c.variant->params : "(defaults)");
+            e.print(stdout);
+        }
+        if (!run_sim) {
+            std::printf("\n");
+            continue;
+        }
+
+        double cycles = 0.0, hold = 0.0;
+        simulate(*c.variant, ram, frames, cycles, hold);
+        const double dc = 100.0 * frame_budget::drift(double(e.frame_cycles), cycles);
+        const double dh = 100.0 * frame_budget::drift(double(e.bus_hold_cycles), hold);
+        const bool   ok = dc <= tolerance && dh <= tolerance;
+        drifted += !ok;
+
+        std::printf("simulated    %s: %.0f cycles/frame (%.2f%% off), %.0f hold/frame (%.2f%% off)%s\n\n",
+                    c.variant->name, cycles, dc, hold, dh, ok ? "" : "  DRIFT");
+    }
+
+    if (drifted) {
+        std::printf("%d configuration(s) drifted more than %.1f%% from the model\n", drifted, tolerance);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,212 @@
+//
+// mud16_fuzz: randomized bus-arbitration fuzzer
+//
+// Runs many systems in parallel, each with the CPU stand-in's BG/AS timing
+// drawn from its own seed, for millions of cycles. The always-on BusMonitor
+// in Mud16System flags protocol violations; failing seeds are re-run with the
+// random ranges narrowed as far as they still fail, and printed as a
+// command line that reproduces them.
+//
+// usage: mud16_fuzz [--seeds N] [--first-seed S] [--cycles C] [-j N]
+//                   [--grant MIN:MAX] [--cycle-len MAX] [--idle MAX]
+//        mud16_fuzz --seed S [...]      replay a single seed
+//
+
+#include "mud16_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Outcome {
+    BusMonitor::Violation violation = BusMonitor::NONE;
+    uint64_t              cycle     = 0;
+    uint64_t              simulated = 0;
+};
+
+struct Failure {
+    uint64_t     seed;
+    CpuBusConfig original;
+    Outcome      first;
+    CpuBusConfig minimized;
+    Outcome      minimized_outcome;
+};
+
+static constexpr uint64_t chunk_cycles = 1 << 16;
+
+// -----------------------------------------------------------------------------
+// Runner
+// -----------------------------------------------------------------------------
+
+static Outcome run_case(const CpuBusConfig& cfg, uint64_t max_cycles) {
+    Mud16System sys;
+    sys.configure_cpu(cfg);
+    sys.reset();
+
+    while (sys.tick_count < max_cycles && sys.monitor.ok()) {
+        sys.step_cycles(std::min<uint64_t>(chunk_cycles, max_cycles - sys.tick_count));
+    }
+
+    Outcome o;
+    o.violation = sys.monitor.first;
+    o.cycle     = sys.monitor.first_cycle;
+    o.simulated = sys.tick_count;
+    return o;
+}
+
+// Smallest value of `knob` in [lo, knob] that still fails the same way
+static void shrink(CpuBusConfig& cfg, int CpuBusConfig::*knob, int lo,
+                   BusMonitor::Violation want, uint64_t budget, Outcome& best) {
+    int hi = cfg.*knob;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        CpuBusConfig trial = cfg;
+        trial.*knob = mid;
+        Outcome o = run_case(trial, budget);
+        if (o.violation == want) {
+            hi = mid;
+            best = o;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    cfg.*knob = hi;
+}
+
+static Failure minimize(uint64_t seed, const CpuBusConfig& cfg, const Outcome& first, uint64_t budget) {
+    Failure f;
+    f.seed      = seed;
+    f.original  = cfg;
+    f.first     = first;
+    f.minimized = cfg;
+    f.minimized_outcome = first;
+
+    CpuBusConfig& m = f.minimized;
+    shrink(m, &CpuBusConfig::grant_delay_max, m.grant_delay_min, first.violation, budget, f.minimized_outcome);
+    shrink(m, &CpuBusConfig::cycle_len_max, 1, first.violation, budget, f.minimized_outcome);
+    shrink(m, &CpuBusConfig::idle_len_max, 0, first.violation, budget, f.minimized_outcome);
+
+    // Collapse the grant range from below as well
+    CpuBusConfig fixed = m;
+    fixed.grant_delay_min = fixed.grant_delay_max;
+    Outcome o = run_case(fixed, budget);
+    if (o.violation == first.violation) {
+        m = fixed;
+        f.minimized_outcome = o;
+    }
+    return f;
+}
+
+// -----------------------------------------------------------------------------
+// Main
+// -----------------------------------------------------------------------------
+
+static void usage() {
+    std::fprintf(stderr,
+        "usage: mud16_fuzz [--seeds N] [--first-seed S] [--seed S] [--cycles C] [-j N]\n"
+        "                  [--grant MIN:MAX] [--cycle-len MAX] [--idle MAX]\n");
+}
+
+static void print_repro(const CpuBusConfig& c, uint64_t cycles) {
+    std::printf("mud16_fuzz --seed %llu --grant %d:%d --cycle-len %d --idle %d --cycles %llu",
+                static_cast<unsigned long long>(c.seed), c.grant_delay_min, c.grant_delay_max,
+                c.cycle_len_max, c.idle_len_max, static_cast<unsigned long long>(cycles));
+}
+
+int main(int argc, char** argv) {
+    uint64_t seeds      = 64;
+    uint64_t first_seed = 1;
+    uint64_t cycles     = 2000000;
+    unsigned jobs       = 0;
+    bool     replay     = false;
+
+    CpuBusConfig base;
+    base.randomize       = true;
+    base.grant_delay_min = 0;
+    base.grant_delay_max = 32;
+    base.cycle_len_max   = 8;
+    base.idle_len_max    = 16;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_arg = i + 1 < argc;
+        if (a == "--seeds" && has_arg) {
+            seeds = std::strtoull(argv[++i], nullptr, 0);
+        } else if (a == "--first-seed" && has_arg) {
+            first_seed = std::strtoull(argv[++i], nullptr, 0);
+        } else if (a == "--seed" && has_arg) {
+            first_seed = std::strtoull(argv[++i], nullptr, 0);
+            seeds  = 1;
+            replay = true;
+        } else if (a == "--cycles" && has_arg) {
+            cycles = std::strtoull(argv[++i], nullptr, 0);
+        } else if (a == "-j" && has_arg) {
+            jobs = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (a == "--grant" && has_arg) {
+            if (std::sscanf(argv[++i], "%d:%d", &base.grant_delay_min, &base.grant_delay_max) != 2) {
+                usage();
+                return 2;
+            }
+        } else if (a == "--cycle-len" && has_arg) {
+            base.cycle_len_max = std::max(1, std::atoi(argv[++i]));
+        } else if (a == "--idle" && has_arg) {
+            base.idle_len_max = std::max(0, std::atoi(argv[++i]));
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (base.grant_delay_max < base.grant_delay_min) std::swap(base.grant_delay_min, base.grant_delay_max);
+
+    if (!jobs) jobs = std::max(1u, std::thread::hardware_concurrency());
+    jobs = static_cast<unsigned>(std::min<uint64_t>(jobs, seeds));
+
+    std::atomic<uint64_t> next{0};
+    std::atomic<uint64_t> total_cycles{0};
+    std::mutex            lock;
+    std::vector<Failure>  failures;
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < jobs; ++w) {
+        workers.emplace_back([&]() {
+            for (uint64_t i = next++; i < seeds; i = next++) {
+                CpuBusConfig cfg = base;
+                cfg.seed = first_seed + i;
+
+                Outcome o = run_case(cfg, cycles);
+                total_cycles += o.simulated;
+                if (o.violation == BusMonitor::NONE) continue;
+
+                // Narrowed configs may fail later, so they get the full budget
+                Failure f = replay ? Failure{cfg.seed, cfg, o, cfg, o}
+                                   : minimize(cfg.seed, cfg, o, cycles);
+                std::lock_guard<std::mutex> guard(lock);
+                failures.push_back(f);
+            }
+        });
+    }
+    for (auto& t : workers) t.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::sort(failures.begin(), failures.end(), [](const Failure& a, const Failure& b) { return a.seed < b.seed; });
+    for (const Failure& f : failures) {
+        std::printf("FAIL seed %llu: %s at cycle %llu\n", static_cast<unsigned long long>(f.seed),
+                    BusMonitor::name(f.first.violation), static_cast<unsigned long long>(f.first.cycle));
+        std::printf("  minimized: ");
+        print_repro(f.minimized, f.minimized_outcome.cycle + 1);
+        std::printf("\n");
+    }
+
+    std::printf("%llu seeds, %zu failing, %.1fM cycles in %.2fs (%.2f Mcycles/s, %u jobs)\n",
+                static_cast<unsigned long long>(seeds), failures.size(), total_cycles / 1e6, secs,
+                secs > 0 ? total_cycles / 1e6 / secs : 0.0, jobs);
+    return failures.empty() ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+//
+// mud16_mkflash: boot flash image builder
+//
+// Turns a scene or RAM image into the flash image boot_loader.sv streams
+// into SRAM after reset (see boot_image.h): the non-zero parts of RAM as
+// segments, LZ compressed with --lz where that is smaller. The image is
+// checked by expanding it again before it is written.
+//
+// usage: mud16_mkflash [--scene demo|stress|world|<ram image>] [--lz] [--gap N] --out FILE
+//
+
+#include "boot_image.h"
+#include "mud16_system.h"
+#include "vram_init_data.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static bool build_scene(const std::string& scene, std::vector<uint8_t>& ram) {
+    ram.assign(Mud16System::ram_size, 0);
+
+    if (scene == "demo") {
+        vram_init::load(ram);
+    } else if (scene == "stress") {
+        vram_init::load_stress(ram);
+    } else if (scene == "world") {
+        vram_init::load_world(ram, 500, 5);
+    } else {
+        std::ifstream in(scene, std::ios::binary);
+        if (!in) return false;
+        std::vector<uint8_t> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (image.size() > ram.size()) image.resize(ram.size());
+        std::copy(image.begin(), image.end(), ram.begin());
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string scene = "demo";
+    std::string out_file;
+    bool        lz    = false;
+    std::size_t gap   = 64;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--scene" && i + 1 < argc) {
+            scene = argv[++i];
+        } else if (a == "--lz") {
+            lz = true;
+        } else if (a == "--gap" && i + 1 < argc) {
+            gap = std::strtoul(argv[++i], nullptr, 0);
+        } else if (a == "--out" && i + 1 < argc) {
+            out_file = argv[++i];
+        } else {
+            out_file.clear();
+            break;
+        }
+    }
+    if (out_file.empty()) {
+        std::fprintf(stderr, "usage: mud16_mkflash [--scene demo|stress|world|<ram image>] [--lz] [--gap N] --out FILE\n");
+        return 2;
+    }
+
+    std::vector<uint8_t> ram;
+    if (!build_scene(scene, ram)) {
+        std::fprintf(stderr, "cannot load scene %s\n", scene.c_str());
+        return 2;
+    }
+
+    const std::vector<boot_image::Segment> segments = boot_image::from_ram(ram.data(), ram.size(), gap);
+    const std::vector<uint8_t>             image    = boot_image::build(segments, lz);
+
+    std::size_t loaded = 0;
+    for (const auto& s : segments) loaded += s.data.size();
+
+    std::vector<uint8_t> check(ram.size(), 0);
+    if (!boot_image::load(image.data(), image.size(), check.data(), check.size()) || check != ram) {
+        std::fprintf(stderr, "image does not expand to the scene\n");
+        return 1;
+    }
+    if (image.size() > SpiFlash::capacity) {
+        std::fprintf(stderr, "image is %zu bytes, the flash holds %zu\n", image.size(), SpiFlash::capacity);
+        return 1;
+    }
+
+    std::ofstream out(out_file, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    if (!out) {
+        std::fprintf(stderr, "cannot write %s\n", out_file.c_str());
+        return 1;
+    }
+
+    std::printf("scene            %s\n", scene.c_str());
+    std::printf("segments         %zu, %zu bytes of RAM\n", segments.size(), loaded);
+    std::printf("flash image      %zu bytes (%.1f%% of the RAM loaded)%s\n", image.size(),
+                loaded ? 100.0 * image.size() / loaded : 0.0, lz ? ", LZ" : "");
+    std::printf("written          %s\n", out_file.c_str());
+    return 0;
+}
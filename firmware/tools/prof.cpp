@@ -0,0 +1,116 @@
+//
+// mud16_prof: bus cycle profile
+//
+// Runs a scene and charges every PPU cycle to what the CPU was doing on the
+// bus: running, stalled on the PPU's bus request, or off the bus while the
+// PPU fetches a region (see cycle_profile.h). Prints the split, the fetch
+// cycles per symbol and the busiest addresses, and writes folded stacks for
+// flame graph tools with --folded.
+//
+// Symbols default to the PPU's regions as the registers place them;
+// --symbols adds names from a file ("ADDR NAME" or nm output, hex).
+//
+// usage: mud16_prof [--scene demo|stress|world|<ram image>] [--frames N] [--symbols FILE]
+//                   [--folded FILE] [--top N] [--cpu-clock HZ]
+//
+
+#include "cycle_profile.h"
+#include "mud16_system.h"
+#include "vram_init_data.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static bool build_scene(const std::string& scene, std::vector<uint8_t>& ram) {
+    ram.assign(Mud16System::ram_size, 0);
+
+    if (scene == "demo") {
+        vram_init::load(ram);
+    } else if (scene == "stress") {
+        vram_init::load_stress(ram);
+    } else if (scene == "world") {
+        vram_init::load_world(ram, 500, 5);
+    } else {
+        std::ifstream in(scene, std::ios::binary);
+        if (!in) return false;
+        std::vector<uint8_t> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (image.size() > ram.size()) image.resize(ram.size());
+        std::copy(image.begin(), image.end(), ram.begin());
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string scene  = "demo";
+    std::string symbol_file;
+    std::string folded_file;
+    uint32_t    frames = 10;
+    int         top    = 10;
+    cycle_profile::Profiler prof;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--scene" && i + 1 < argc) {
+            scene = argv[++i];
+        } else if (a == "--frames" && i + 1 < argc) {
+            frames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (a == "--symbols" && i + 1 < argc) {
+            symbol_file = argv[++i];
+        } else if (a == "--folded" && i + 1 < argc) {
+            folded_file = argv[++i];
+        } else if (a == "--top" && i + 1 < argc) {
+            top = static_cast<int>(std::strtol(argv[++i], nullptr, 0));
+        } else if (a == "--cpu-clock" && i + 1 < argc) {
+            prof.cpu_clock_hz = std::strtod(argv[++i], nullptr);
+        } else {
+            std::fprintf(stderr, "usage: mud16_prof [--scene demo|stress|world|<ram image>] [--frames N] [--symbols FILE]\n"
+                                 "                  [--folded FILE] [--top N] [--cpu-clock HZ]\n");
+            return 2;
+        }
+    }
+
+    std::vector<uint8_t> ram;
+    if (!build_scene(scene, ram)) {
+        std::fprintf(stderr, "cannot load scene %s\n", scene.c_str());
+        return 2;
+    }
+
+    cycle_profile::SymbolTable symbols = cycle_profile::default_symbols(ram.data(), ram.size());
+    if (!symbol_file.empty() && !symbols.load(symbol_file)) {
+        std::fprintf(stderr, "cannot read symbols %s\n", symbol_file.c_str());
+        return 2;
+    }
+
+    Mud16System sys;
+    sys.load_image(ram.data(), ram.size());
+    sys.reset();
+
+    const uint64_t target = sys.stats().frames + frames;
+    while (sys.stats().frames < target) {
+        sys.tick();
+        prof.sample(sys.ppu->ppu_br_n, sys.ppu->ppu_bgack_n, sys.ppu->mem_read || sys.ppu->mem_write,
+                    sys.ppu->mem_addr);
+    }
+    prof.finish();
+
+    std::printf("scene            %s\n", scene.c_str());
+    std::printf("frames           %u\n", frames);
+    prof.print(stdout, symbols, top);
+
+    if (!folded_file.empty()) {
+        FILE* out = std::fopen(folded_file.c_str(), "w");
+        if (!out) {
+            std::fprintf(stderr, "cannot write %s\n", folded_file.c_str());
+            return 1;
+        }
+        prof.write_folded(out, symbols);
+        std::fclose(out);
+        std::printf("folded stacks    %s\n", folded_file.c_str());
+    }
+    return 0;
+}
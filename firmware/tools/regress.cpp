@@ -0,0 +1,370 @@
+//
+// mud16_regress: golden-frame regression runner
+//
+// Runs every scene listed in <scene_dir>/scenes.txt headlessly, one system
+// per worker thread, hashes each frame and compares against the golden
+// hashes in <scene_dir>/golden/. PNGs are only written for mismatches.
+//
+// scenes.txt, one scene per line ('#' starts a comment):
+//     <name> <ram image, relative to scene_dir> <frames>
+//
+// golden/<name>.hash  one 64-bit hex hash per frame
+// golden/<name>.rgba  raw RGBA8 copy of the last frame, used for diff images
+//
+// Each scene is also run in the fast tick mode (tick_check), with fixed and
+// randomized CPU timing, and fails if that differs from the normal tick: the
+// fast tick relies on Verilator-internal clock state (see CMakeLists.txt).
+// It is run with the frame cache too, against an uncached run, across cache
+// hits followed by a miss from an OAM write.
+//
+// usage: mud16_regress <scene_dir> [-j N] [--update] [--out DIR] [--write-demo]
+//
+
+#include "mud16_system.h"
+#include "vram_init_data.h"
+#include "frame_hash.h"
+#include "png_writer.h"
+#include "ppu_regs.h"
+#include "tick_check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct Scene {
+    std::string name;
+    std::string image;
+    int         frames = 0;
+};
+
+struct Result {
+    bool        pass           = false;
+    bool        missing_golden = false;
+    int         first_bad      = -1;
+    uint64_t    expected       = 0;
+    uint64_t    actual         = 0;
+    double      seconds        = 0.0;
+    std::string error;
+};
+
+struct Options {
+    fs::path dir;
+    fs::path out;
+    unsigned jobs       = 0;
+    bool     update     = false;
+    bool     write_demo = false;
+};
+
+static const std::size_t frame_bytes = static_cast<std::size_t>(Mud16System::width) * Mud16System::height * 4;
+
+// -----------------------------------------------------------------------------
+// Files
+// -----------------------------------------------------------------------------
+
+static bool read_file(const fs::path& path, std::vector<uint8_t>& data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool write_file(const fs::path& path, const uint8_t* data, std::size_t len) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(len));
+    return static_cast<bool>(out);
+}
+
+static bool load_manifest(const fs::path& dir, std::vector<Scene>& scenes) {
+    std::ifstream in(dir / "scenes.txt");
+    if (!in) return false;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream ls(line);
+        Scene s;
+        if (ls >> s.name >> s.image >> s.frames && s.frames > 0) {
+            scenes.push_back(s);
+        }
+    }
+    return true;
+}
+
+static bool load_golden(const fs::path& path, std::vector<uint64_t>& hashes) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string tok;
+    while (in >> tok) {
+        hashes.push_back(std::strtoull(tok.c_str(), nullptr, 16));
+    }
+    return true;
+}
+
+static bool save_golden(const fs::path& path, const std::vector<uint64_t>& hashes) {
+    std::ofstream out(path);
+    for (uint64_t h : hashes) {
+        char buf[20];
+        std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(h));
+        out << buf << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+// Red where pixels differ, dimmed expected image elsewhere
+static void write_diff(const fs::path& path, const uint8_t* expected, const uint8_t* actual) {
+    std::vector<uint8_t> diff(frame_bytes);
+    for (std::size_t i = 0; i < frame_bytes; i += 4) {
+        bool same = std::memcmp(expected + i, actual + i, 3) == 0;
+        diff[i + 0] = same ? expected[i + 0] / 4 : 255;
+        diff[i + 1] = same ? expected[i + 1] / 4 : 0;
+        diff[i + 2] = same ? expected[i + 2] / 4 : 0;
+        diff[i + 3] = 255;
+    }
+    png_writer::write_rgba(path.string(), Mud16System::width, Mud16System::height, diff.data());
+}
+
+// -----------------------------------------------------------------------------
+// Scene runner
+// -----------------------------------------------------------------------------
+
+// Frame cache hits must leave the system where an uncached run would be, so
+// the simulated frames after them match too. Half way, once frames have come
+// from the cache, moves object 0 to force a miss.
+static void check_frame_cache(const std::vector<uint8_t>& image, const Scene& scene, Result& r) {
+    Mud16System full, cached;
+    for (Mud16System* sys : {&full, &cached}) {
+        sys->load_image(image.data(), image.size());
+        sys->reset();
+    }
+    cached.set_frame_cache(true);
+
+    const int frames = std::max(scene.frames, 8);
+    for (int f = 0; f < frames; ++f) {
+        if (f == frames / 2) {
+            if (cached.stats().cached_frames == 0) return; // nothing was reused, e.g. animated scenes
+            const uint32_t oam = ppu_regs::Regs::from_ram(image.data(), image.size()).oam_base();
+            uint8_t x = 0;
+            if (!full.read_ram(oam, &x, 1)) return;
+            x++;
+            full.write_ram(oam, &x, 1);
+            cached.write_ram(oam, &x, 1);
+        }
+
+        full.step_frames(1);
+        cached.step_frames(1);
+        const Mud16Stats a = full.stats(), b = cached.stats();
+        if (frame_hash::hash64(full.framebuffer(), frame_bytes) != frame_hash::hash64(cached.framebuffer(), frame_bytes) ||
+            a.cycles != b.cycles || a.bus_hold_cycles != b.bus_hold_cycles) {
+            r.pass  = false;
+            r.error = "frame cache differs at frame " + std::to_string(f) + " (" +
+                      std::to_string(b.cached_frames) + " cached before it)";
+            return;
+        }
+    }
+}
+
+static void check_fast_tick(const std::vector<uint8_t>& image, const Scene& scene, Result& r) {
+    CpuBusConfig random;
+    random.randomize       = true;
+    random.grant_delay_min = 0;
+    random.grant_delay_max = 32;
+    random.cycle_len_max   = 8;
+    random.idle_len_max    = 16;
+
+    for (const CpuBusConfig& cpu : {CpuBusConfig{}, random}) {
+        const tick_check::Result t = tick_check::run(image, static_cast<uint32_t>(scene.frames), cpu);
+        if (!t.supported) return; // built with MUD16_FAST_TICK=OFF
+        if (!t.ok) {
+            r.pass  = false;
+            r.error = std::string("fast tick differs at frame ") + std::to_string(t.first_mismatch) +
+                      (cpu.randomize ? " (random CPU timing)" : " (fixed CPU timing)");
+            return;
+        }
+    }
+}
+
+static Result run_scene(const Options& opt, const Scene& scene) {
+    Result r;
+    auto t0 = std::chrono::steady_clock::now();
+
+    std::vector<uint8_t> image;
+    if (!read_file(opt.dir / scene.image, image)) {
+        r.error = "cannot read " + scene.image;
+        return r;
+    }
+    image.resize(Mud16System::ram_size, 0);
+
+    const fs::path golden_dir = opt.dir / "golden";
+    std::vector<uint64_t> golden;
+    if (!opt.update && !load_golden(golden_dir / (scene.name + ".hash"), golden)) {
+        r.missing_golden = true;
+        r.error = "no golden hashes (run with --update)";
+        return r;
+    }
+
+    Mud16System sys;
+    sys.load_image(image.data(), image.size());
+    sys.reset();
+
+    std::vector<uint64_t> hashes;
+    hashes.reserve(scene.frames);
+
+    for (int f = 0; f < scene.frames; ++f) {
+        sys.step_frames(1);
+        uint64_t h = frame_hash::hash64(sys.framebuffer(), frame_bytes);
+        hashes.push_back(h);
+
+        if (opt.update || r.first_bad >= 0) continue;
+
+        uint64_t expected = (f < (int)golden.size()) ? golden[f] : 0;
+        if (h != expected) {
+            r.first_bad = f;
+            r.expected  = expected;
+            r.actual    = h;
+            png_writer::write_rgba((opt.out / (scene.name + "_f" + std::to_string(f) + ".png")).string(),
+                                   Mud16System::width, Mud16System::height, sys.framebuffer());
+        }
+    }
+
+    if (opt.update) {
+        fs::create_directories(golden_dir);
+        bool ok = save_golden(golden_dir / (scene.name + ".hash"), hashes)
+               && write_file(golden_dir / (scene.name + ".rgba"), sys.framebuffer(), frame_bytes);
+        if (!ok) r.error = "cannot write golden files";
+        r.pass = ok;
+    } else if (golden.size() != hashes.size()) {
+        r.error = "golden has " + std::to_string(golden.size()) + " frames";
+    } else if (r.first_bad < 0) {
+        r.pass = true;
+    } else if (hashes.back() != golden.back()) {
+        // Diff the final frame against the stored reference
+        std::vector<uint8_t> ref;
+        if (read_file(golden_dir / (scene.name + ".rgba"), ref) && ref.size() == frame_bytes) {
+            const std::string base = (opt.out / scene.name).string();
+            png_writer::write_rgba(base + "_expected.png", Mud16System::width, Mud16System::height, ref.data());
+            png_writer::write_rgba(base + "_actual.png", Mud16System::width, Mud16System::height, sys.framebuffer());
+            write_diff(base + "_diff.png", ref.data(), sys.framebuffer());
+        }
+    }
+
+    if (!opt.update && r.pass) check_fast_tick(image, scene, r);
+    if (!opt.update && r.pass) check_frame_cache(image, scene, r);
+
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return r;
+}
+
+static bool write_demo_scene(const fs::path& dir) {
+    static constexpr uint32_t vram_bytes = vram_init::Layout::oam_base + vram_init::Layout::oam_bytes;
+    std::vector<uint8_t> ram(vram_bytes, 0);
+    vram_init::load(ram);
+
+    fs::create_directories(dir);
+    if (!write_file(dir / "demo.bin", ram.data(), ram.size())) return false;
+
+    std::vector<Scene> scenes;
+    load_manifest(dir, scenes);
+    bool listed = std::any_of(scenes.begin(), scenes.end(), [](const Scene& s) { return s.name == "demo"; });
+    if (!listed) {
+        std::ofstream out(dir / "scenes.txt", std::ios::app);
+        out << "demo demo.bin 4\n";
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Main
+// -----------------------------------------------------------------------------
+
+static void usage() {
+    std::fprintf(stderr, "usage: mud16_regress <scene_dir> [-j N] [--update] [--out DIR] [--write-demo]\n");
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "-j" && i + 1 < argc) {
+            opt.jobs = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (a == "--update") {
+            opt.update = true;
+        } else if (a == "--out" && i + 1 < argc) {
+            opt.out = argv[++i];
+        } else if (a == "--write-demo") {
+            opt.write_demo = true;
+        } else if (!a.empty() && a[0] != '-' && opt.dir.empty()) {
+            opt.dir = a;
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (opt.dir.empty()) {
+        usage();
+        return 2;
+    }
+
+    if (opt.write_demo && !write_demo_scene(opt.dir)) {
+        std::fprintf(stderr, "cannot write demo scene to %s\n", opt.dir.string().c_str());
+        return 2;
+    }
+
+    std::vector<Scene> scenes;
+    if (!load_manifest(opt.dir, scenes) || scenes.empty()) {
+        std::fprintf(stderr, "no scenes in %s\n", (opt.dir / "scenes.txt").string().c_str());
+        return 2;
+    }
+
+    if (opt.out.empty()) opt.out = opt.dir / "failures";
+    if (!opt.update) fs::create_directories(opt.out);
+
+    unsigned jobs = opt.jobs ? opt.jobs : std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::min<unsigned>(jobs, static_cast<unsigned>(scenes.size()));
+
+    std::vector<Result> results(scenes.size());
+    std::atomic<std::size_t> next{0};
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < jobs; ++w) {
+        workers.emplace_back([&]() {
+            for (std::size_t i = next++; i < scenes.size(); i = next++) {
+                results[i] = run_scene(opt, scenes[i]);
+            }
+        });
+    }
+    for (auto& t : workers) t.join();
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    int failed = 0;
+    for (std::size_t i = 0; i < scenes.size(); ++i) {
+        const Scene& s = scenes[i];
+        const Result& r = results[i];
+        if (r.pass) {
+            std::printf("%s %-20s %4d frames  %.2fs\n", opt.update ? "UPDATED" : "PASS   ", s.name.c_str(), s.frames, r.seconds);
+            continue;
+        }
+        failed++;
+        if (r.first_bad >= 0) {
+            std::printf("FAIL    %-20s frame %d: expected %016llx got %016llx\n", s.name.c_str(), r.first_bad,
+                        static_cast<unsigned long long>(r.expected), static_cast<unsigned long long>(r.actual));
+        } else {
+            std::printf("FAIL    %-20s %s\n", s.name.c_str(), r.error.c_str());
+        }
+    }
+
+    std::printf("%zu scenes, %d failed, %u jobs, %.2fs\n", scenes.size(), failed, jobs, total);
+    if (failed && !opt.update) std::printf("mismatch images in %s\n", opt.out.string().c_str());
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,105 @@
+//
+// mud16_tickcheck: equivalence check for the fast tick mode
+//
+// Runs the demo and stress scenes, with the fixed CPU timing and with a few
+// randomized ones, in the normal and the fast tick mode side by side and
+// compares every frame (see tick_check.h). Exits non-zero on the first
+// difference, in which case the fast mode must not be used.
+//
+// usage: mud16_tickcheck [--frames N] [--seeds N] [-j N]
+//
+
+#include "tick_check.h"
+#include "vram_init_data.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Case {
+    std::string                 name;
+    const std::vector<uint8_t>* ram;
+    CpuBusConfig                cpu;
+    tick_check::Result          result;
+};
+
+int main(int argc, char** argv) {
+    uint32_t frames = 2000;
+    uint64_t seeds  = 2;
+    unsigned jobs   = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_arg = i + 1 < argc;
+        if (a == "--frames" && has_arg) {
+            frames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (a == "--seeds" && has_arg) {
+            seeds = std::strtoull(argv[++i], nullptr, 0);
+        } else if (a == "-j" && has_arg) {
+            jobs = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else {
+            std::fprintf(stderr, "usage: mud16_tickcheck [--frames N] [--seeds N] [-j N]\n");
+            return 2;
+        }
+    }
+
+    if (!Mud16System::fast_tick_supported()) {
+        std::printf("fast tick not supported by this Verilated model\n");
+        return 1;
+    }
+
+    std::vector<uint8_t> demo(Mud16System::ram_size, 0), stress(Mud16System::ram_size, 0);
+    vram_init::load(demo);
+    vram_init::load_stress(stress);
+
+    std::vector<Case> cases;
+    for (auto scene : {std::make_pair("demo", &demo), std::make_pair("stress", &stress)}) {
+        cases.push_back({std::string(scene.first) + "/fixed", scene.second, CpuBusConfig{}, {}});
+        for (uint64_t s = 1; s <= seeds; s++) {
+            CpuBusConfig cpu;
+            cpu.randomize       = true;
+            cpu.seed            = s;
+            cpu.grant_delay_min = 0;
+            cpu.grant_delay_max = 32;
+            cpu.cycle_len_max   = 8;
+            cpu.idle_len_max    = 16;
+            cases.push_back({std::string(scene.first) + "/seed" + std::to_string(s), scene.second, cpu, {}});
+        }
+    }
+
+    if (!jobs) jobs = std::max(1u, std::thread::hardware_concurrency());
+    jobs = static_cast<unsigned>(std::min<std::size_t>(jobs, cases.size()));
+
+    std::atomic<std::size_t> next{0};
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < jobs; ++w) {
+        workers.emplace_back([&]() {
+            for (std::size_t i = next++; i < cases.size(); i = next++) {
+                cases[i].result = tick_check::run(*cases[i].ram, frames, cases[i].cpu);
+            }
+        });
+    }
+    for (auto& t : workers) t.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    int failed = 0;
+    for (const Case& c : cases) {
+        const tick_check::Result& r = c.result;
+        if (r.ok) {
+            std::printf("ok    %-14s %u frames\n", c.name.c_str(), r.frames_checked);
+        } else {
+            failed++;
+            std::printf("FAIL  %-14s frame %u: full %016llx fast %016llx\n", c.name.c_str(),
+                        r.first_mismatch, static_cast<unsigned long long>(r.hash_full),
+                        static_cast<unsigned long long>(r.hash_fast));
+        }
+    }
+    std::printf("%zu cases, %d failing, %.2fs\n", cases.size(), failed, secs);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,174 @@
+//
+// mud16_variants: compare PPU parameter variants
+//
+// Runs every variant from MUD16_PPU_VARIANTS (see mud16_variants.h) on the
+// same scenes in parallel and prints cycles/frame, bus hold cycles/frame and
+// the model's eval cost per cycle, relative to the "base" variant.
+//
+// Variants that only change bus timing (MEM_WIDTH, BUS_READ_LATENCY) must
+// draw the same last frame as base; a difference fails the run (exit 1).
+// The default scenes include "world", so wide32 covers world map mode.
+//
+// usage: mud16_variants [--scene demo|stress|world|<ram image>]... [--frames N] [-j N]
+//                       [--only name,name]
+//
+
+#include "mud16_variants.h"
+#include "vram_init_data.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Job {
+    const mud16_variants::Variant* variant;
+    std::size_t                    scene;
+    mud16_variants::Result         result;
+};
+
+static bool build_scene(const std::string& scene, std::vector<uint8_t>& ram) {
+    ram.assign(Mud16System::ram_size, 0);
+
+    if (scene == "demo") {
+        vram_init::load(ram);
+    } else if (scene == "stress") {
+        vram_init::load_stress(ram);
+    } else if (scene == "world") {
+        vram_init::load_world(ram, 500, 5);
+    } else {
+        std::ifstream in(scene, std::ios::binary);
+        if (!in) return false;
+        std::vector<uint8_t> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (image.size() > ram.size()) image.resize(ram.size());
+        std::copy(image.begin(), image.end(), ram.begin());
+    }
+    return true;
+}
+
+static bool selected(const std::string& only, const char* name) {
+    if (only.empty()) return true;
+    std::string list = "," + only + ",";
+    return list.find("," + std::string(name) + ",") != std::string::npos;
+}
+
+static double per_frame(uint64_t value, const Mud16Stats& st) {
+    return st.frames ? double(value) / st.frames : 0.0;
+}
+
+static bool timing_only(const char* params) {
+    if (!*params) return false;
+    std::string list = std::string(params) + ",";
+    for (std::size_t start = 0, end; (end = list.find(',', start)) != std::string::npos; start = end + 1) {
+        const std::string key = list.substr(start, list.find('=', start) - start);
+        if (key != "MEM_WIDTH" && key != "BUS_READ_LATENCY") return false;
+    }
+    return true;
+}
+
+static double ns_per_cycle(const mud16_variants::Result& r) {
+    return r.stats.cycles ? r.seconds * 1e9 / r.stats.cycles : 0.0;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> scenes;
+    std::string only;
+    uint32_t    frames = 30;
+    unsigned    jobs   = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        bool has_arg = i + 1 < argc;
+        if (a == "--scene" && has_arg) {
+            scenes.push_back(argv[++i]);
+        } else if (a == "--frames" && has_arg) {
+            frames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+        } else if (a == "-j" && has_arg) {
+            jobs = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (a == "--only" && has_arg) {
+            only = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: mud16_variants [--scene demo|stress|world|<ram image>]... [--frames N] [-j N]\n"
+                                 "                      [--only name,name]\n");
+            return 2;
+        }
+    }
+    if (scenes.empty()) scenes = {"demo", "stress", "world"};
+
+    std::vector<std::vector<uint8_t>> rams(scenes.size());
+    for (std::size_t s = 0; s < scenes.size(); s++) {
+        if (!build_scene(scenes[s], rams[s])) {
+            std::fprintf(stderr, "cannot load scene %s\n", scenes[s].c_str());
+            return 2;
+        }
+    }
+
+    std::vector<Job> work;
+    for (const auto& v : mud16_variants::all()) {
+        if (!selected(only, v.name)) continue;
+        for (std::size_t s = 0; s < scenes.size(); s++) work.push_back({&v, s, {}});
+    }
+    if (work.empty()) {
+        std::fprintf(stderr, "no variants selected\n");
+        return 2;
+    }
+
+    // Eval cost is wall time, so by default leave a core free for the OS
+    if (!jobs) jobs = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    jobs = static_cast<unsigned>(std::min<std::size_t>(jobs, work.size()));
+
+    std::atomic<std::size_t> next{0};
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < jobs; ++w) {
+        workers.emplace_back([&]() {
+            for (std::size_t i = next++; i < work.size(); i = next++) {
+                work[i].result = work[i].variant->run(rams[work[i].scene], frames);
+            }
+        });
+    }
+    for (auto& t : workers) t.join();
+
+    std::printf("%u frames per run, %u jobs\n\n", frames, jobs);
+    int failed = 0;
+    for (std::size_t s = 0; s < scenes.size(); s++) {
+        const Job* base = nullptr;
+        for (const Job& j : work) {
+            if (j.scene == s && std::string(j.variant->name) == "base") base = &j;
+        }
+
+        std::printf("scene %s\n", scenes[s].c_str());
+        std::printf("  %-10s %-36s %9s %12s %11s %9s %8s %8s\n",
+                    "variant", "params", "size", "cycles/frm", "hold/frm", "ns/cycle", "vs base", "frame");
+        for (const Job& j : work) {
+            if (j.scene != s) continue;
+            const mud16_variants::Result& r = j.result;
+            char size[16];
+            std::snprintf(size, sizeof(size), "%dx%d", j.variant->width, j.variant->height);
+            double rel = base && ns_per_cycle(base->result) > 0 ? ns_per_cycle(r) / ns_per_cycle(base->result) : 0.0;
+
+            // Last frame against base, where the display size matches
+            const char* frame = "-";
+            if (base && &j != base && j.variant->width == base->variant->width &&
+                j.variant->height == base->variant->height) {
+                const bool same = r.frame_hash == base->result.frame_hash;
+                frame = same ? "same" : "differs";
+                if (!same && timing_only(j.variant->params)) failed++;
+            }
+            std::printf("  %-10s %-36s %9s %12.0f %11.0f %9.2f %7.2fx %8s\n", j.variant->name,
+                        *j.variant->params ? j.variant->params : "(defaults)", size,
+                        per_frame(r.stats.cycles, r.stats), per_frame(r.stats.bus_hold_cycles, r.stats),
+                        ns_per_cycle(r), rel, frame);
+        }
+        std::printf("\n");
+    }
+    if (failed) {
+        std::fprintf(stderr, "%d bus timing variant run(s) drew a different frame than base\n", failed);
+        return 1;
+    }
+    return 0;
+}
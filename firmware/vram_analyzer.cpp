@@ -0,0 +1,234 @@
+#include "vram_analyzer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+
+namespace vram_analyzer {
+
+using soft_render::Vram;
+
+static int popcount(uint32_t v) {
+    int n = 0;
+    for (; v; v &= v - 1) n++;
+    return n;
+}
+
+// Bit v set if any pixel of the tile has colour index v
+static uint16_t nibble_mask(const uint8_t* tile) {
+    uint16_t mask = 0;
+    for (int i = 0; i < 32; i++) mask |= static_cast<uint16_t>(1u << (tile[i] >> 4) | 1u << (tile[i] & 0xF));
+    return mask;
+}
+
+using TileBytes = std::array<uint8_t, 32>;
+
+static TileBytes flip(const uint8_t* tile, bool h, bool v) {
+    TileBytes out{};
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            const uint8_t b   = tile[y * 4 + x / 2];
+            const uint8_t pix = (x & 1) ? (b & 0xF) : (b >> 4);
+            const int     dx  = h ? 7 - x : x;
+            const int     dy  = v ? 7 - y : y;
+            out[dy * 4 + dx / 2] |= (dx & 1) ? pix : static_cast<uint8_t>(pix << 4);
+        }
+    }
+    return out;
+}
+
+Analyzer::Analyzer() = default;
+
+void Analyzer::observe(const uint8_t* ram, std::size_t ram_size) {
+    static thread_local Vram vram;
+    Vram::from_ram(ram, ram_size, vram);
+    observe(vram);
+}
+
+void Analyzer::observe(const Vram& vram) {
+    frames++;
+
+    uint16_t masks[RefreshSizes::reachable_tiles];
+    bool     have_mask[RefreshSizes::reachable_tiles] = {};
+    auto mask_of = [&](int tile) {
+        if (!have_mask[tile]) {
+            masks[tile]     = nibble_mask(vram.tiles + tile * 32);
+            have_mask[tile] = true;
+        }
+        return masks[tile];
+    };
+
+    // BG: the visible cells of the 64x64 map or the world map window (one
+    // more row and column when finely scrolled), palette 0, colour 0 is sky
+    world_map  = vram.regs.world_map();
+    tile_remap = vram.regs.tile_remap();
+    sprite_anim = vram.regs.sprite_anim();
+    color_cycle = vram.regs.color_cycle();
+    const int cols = (soft_render::width + vram.regs.fine_x() + 7) / 8;
+    const int rows = (soft_render::height + vram.regs.fine_y() + 7) / 8;
+    for (int ty = 0; ty < rows; ty++) {
+        for (int tx = 0; tx < cols; tx++) {
+            const int cell = ty * 64 + tx;
+            const int tile = vram.remap[vram.bg_map[cell]];
+            bg_cells[cell] = true;
+            remap_used[vram.bg_map[cell]] |= tile_remap;
+            tile_users[tile] |= USED_BY_BG;
+            colors[0] |= mask_of(tile) & ~1u;
+        }
+    }
+
+    // UI: every cell is on screen, palette 0, colour 0 transparent
+    for (int i = 0; i < RefreshSizes::ui_map_bytes; i++) {
+        const int tile = vram.remap[vram.ui_map[i]];
+        remap_used[vram.ui_map[i]] |= tile_remap;
+        tile_users[tile] |= USED_BY_UI;
+        colors[0] |= mask_of(tile) & ~1u;
+    }
+
+    // Objects. ppu.sv reads palette_idx one pixel late, after every enabled
+    // object has overwritten it, so all objects draw with the palette of the
+    // last enabled OAM entry.
+    int drawn_palette = -1;
+    for (int i = 127; i >= 0 && drawn_palette < 0; i--) {
+        if (vram.oam[i] >> 31) drawn_palette = (vram.oam[i] >> 26) & 0x7;
+    }
+    for (int i = 0; i < 128; i++) {
+        const uint32_t word = vram.oam[i];
+        if (!(word >> 31)) continue;
+        palettes_requested |= static_cast<uint8_t>(1u << ((word >> 26) & 0x7));
+
+        const int x = word & 0x1FF, y = (word >> 9) & 0xFF;
+        if (x >= soft_render::width || y >= soft_render::height) continue;
+
+        // Every frame of a PPU-driven animation
+        const int frames = vram.regs.sprite_anim() ? ppu_regs::anim_frames(vram.anim[i]) : 1;
+        for (int f = 0; f < frames; f++) {
+            const int tile = (((((word >> 17) + f) & 0x1FF) * 32) & 0x1FFF) / 32;
+            tile_users[tile] |= USED_BY_OAM;
+            colors[drawn_palette] |= mask_of(tile) & ~0x8000u;
+        }
+        oam_entries[i] = true;
+        palettes_drawn |= static_cast<uint8_t>(1u << drawn_palette);
+    }
+
+    // A cycling range shows each of its colours at some phase, so any pixel
+    // inside it uses the whole range
+    if (vram.regs.color_cycle()) {
+        for (int r = 0; r < ppu_regs::cycle_ranges; r++) {
+            const uint16_t reg = vram.regs.word[ppu_regs::CYCLE0 + r];
+            uint16_t range = 0;
+            for (int c = 0; c < 16; c++) range |= static_cast<uint16_t>(ppu_regs::cycle_covers(reg, reg & 7, c) << c);
+            if (colors[reg & 7] & range) colors[reg & 7] |= range;
+        }
+    }
+
+    last_tiles.assign(vram.tiles, vram.tiles + sizeof(vram.tiles));
+}
+
+Report Analyzer::report() const {
+    Report r;
+    r.frames = frames;
+
+    for (int t = 0; t < RefreshSizes::tile_slots; t++) {
+        const uint8_t u = tile_users[t];
+        r.tiles_bg  += (u & USED_BY_BG) != 0;
+        r.tiles_ui  += (u & USED_BY_UI) != 0;
+        r.tiles_oam += (u & USED_BY_OAM) != 0;
+        r.tiles_used += u != 0;
+        if (!u && !last_tiles.empty()) {
+            const uint8_t* tile = last_tiles.data() + t * 32;
+            r.tiles_unused_nonblank += std::any_of(tile, tile + 32, [](uint8_t b) { return b != 0; });
+        }
+    }
+
+    // Duplicates among referenced tiles: key on the smallest of the four flips
+    if (!last_tiles.empty()) {
+        std::map<TileBytes, DuplicateGroup> groups;
+        for (int t = 0; t < RefreshSizes::tile_slots; t++) {
+            if (!tile_users[t]) continue;
+            const uint8_t* tile = last_tiles.data() + t * 32;
+            TileBytes key = flip(tile, false, false);
+            for (int f = 1; f < 4; f++) key = std::min(key, flip(tile, f & 1, f & 2));
+
+            DuplicateGroup& g = groups[key];
+            if (!g.tiles.empty() && std::memcmp(tile, last_tiles.data() + g.tiles[0] * 32, 32) != 0) g.flipped = true;
+            g.tiles.push_back(t);
+        }
+        for (auto& kv : groups) {
+            if (kv.second.tiles.size() > 1) r.duplicates.push_back(kv.second);
+        }
+    }
+
+    for (int p = 0; p < 8; p++) {
+        if (p == 0 && (r.tiles_bg || r.tiles_ui)) r.palettes_bg_ui.push_back(p);
+        if (palettes_requested & (1u << p)) r.palettes_oam.push_back(p);
+        if (palettes_drawn & (1u << p)) r.palettes_drawn.push_back(p);
+    }
+
+    int colors_used = 0;
+    for (uint16_t c : colors) colors_used += popcount(c);
+    const int cells_used = static_cast<int>(std::count(bg_cells, bg_cells + RefreshSizes::bg_map_bytes, true));
+    const int oam_used   = static_cast<int>(std::count(oam_entries, oam_entries + 128, true));
+    const int registers_used = (world_map ? 14 : 2) + (color_cycle ? 2 * ppu_regs::cycle_ranges : 0);
+    const int remap_used_entries = static_cast<int>(std::count(remap_used, remap_used + ppu_regs::remap_entries, true));
+
+    r.regions = {
+        {"registers", RefreshSizes::reg_bytes,    frames ? registers_used : 0},
+        {"remap",    tile_remap ? RefreshSizes::remap_bytes : 0, remap_used_entries},
+        {"palettes", RefreshSizes::palette_bytes, colors_used * 2},
+        {"tiles",    RefreshSizes::tile_bytes,    r.tiles_used * 32},
+        {world_map ? "BG window" : "BG map", world_map ? RefreshSizes::window_bytes : RefreshSizes::bg_map_bytes,
+                     world_map ? cells_used * 2 : cells_used},
+        {"UI map",   RefreshSizes::ui_map_bytes,  frames ? RefreshSizes::ui_map_bytes : 0},
+        {"OAM",      RefreshSizes::oam_bytes,     oam_used * 4},
+        {"anim",     sprite_anim ? RefreshSizes::anim_bytes : 0, sprite_anim ? oam_used : 0},
+    };
+    for (const Region& g : r.regions) {
+        r.bytes_read += g.read;
+        r.bytes_used += g.used;
+    }
+    return r;
+}
+
+static void print_list(FILE* out, const std::vector<int>& list) {
+    if (list.empty()) std::fprintf(out, " none");
+    for (int v : list) std::fprintf(out, " %d", v);
+    std::fprintf(out, "\n");
+}
+
+void Report::print(FILE* out) const {
+    std::fprintf(out, "frames observed     %llu\n\n", static_cast<unsigned long long>(frames));
+
+    std::fprintf(out, "tiles referenced    %d of %d slots (BG %d, UI %d, OAM %d)\n", tiles_used,
+                 RefreshSizes::tile_slots, tiles_bg, tiles_ui, tiles_oam);
+    std::fprintf(out, "tiles unused        %d (%d of them not blank, %d slots unreachable above %d)\n",
+                 RefreshSizes::tile_slots - tiles_used, tiles_unused_nonblank,
+                 RefreshSizes::tile_slots - RefreshSizes::reachable_tiles, RefreshSizes::reachable_tiles - 1);
+    std::fprintf(out, "duplicate tiles     %zu group(s)\n", duplicates.size());
+    for (const DuplicateGroup& g : duplicates) {
+        std::fprintf(out, "   ");
+        for (int t : g.tiles) std::fprintf(out, " %d", t);
+        std::fprintf(out, "%s\n", g.flipped ? "  (flip-equivalent)" : "");
+    }
+
+    std::fprintf(out, "\npalettes BG/UI     ");
+    print_list(out, palettes_bg_ui);
+    std::fprintf(out, "palettes in OAM    ");
+    print_list(out, palettes_oam);
+    std::fprintf(out, "palettes drawn     ");
+    print_list(out, palettes_drawn);
+    if (palettes_oam.size() > 1) {
+        std::fprintf(out, "  note: ppu.sv draws every object with the last enabled entry's palette\n");
+    }
+
+    std::fprintf(out, "\n%-10s %10s %10s %10s\n", "region", "read", "on screen", "wasted");
+    for (const Region& g : regions) {
+        std::fprintf(out, "%-10s %10d %10d %9.1f%%\n", g.name, g.read, g.used,
+                     g.read ? 100.0 * (g.read - g.used) / g.read : 0.0);
+    }
+    std::fprintf(out, "%-10s %10d %10d %9.1f%%\n", "total", bytes_read, bytes_used,
+                 bytes_read ? 100.0 * (bytes_read - bytes_used) / bytes_read : 0.0);
+}
+
+} // namespace vram_analyzer
@@ -1,4 +1,5 @@
 #include "vram_init_data.h"
+#include "ppu_regs.h"
 
 #include <algorithm>
 #include <cstring>
@@ -202,6 +203,7 @@ void load(uint8_t* ram, std::size_t ram_size) {
     clear_range(ram, ram_size, Layout::bg_map_base, Layout::bg_map_bytes);
     clear_range(ram, ram_size, Layout::ui_map_base, Layout::ui_map_bytes);
     clear_range(ram, ram_size, Layout::oam_base, Layout::oam_bytes);
+    clear_range(ram, ram_size, Layout::reg_base, Layout::reg_bytes);
 
     // Palettes
     for (int p = 0; p < Params::palette_count; ++p) {
@@ -277,4 +279,195 @@ void load(std::vector<uint8_t>& ram) {
     load(ram.data(), ram.size());
 }
 
+void load_stress(uint8_t* ram, std::size_t ram_size) {
+    load(ram, ram_size);
+    if (!ram || ram_size == 0) return;
+
+    // BG: every cell uses one of the world tiles 1-12
+    for (int y = 0; y < Params::bg_map_h_tiles; ++y) {
+        for (int x = 0; x < Params::bg_map_w_tiles; ++x) {
+            uint32_t off = Layout::bg_map_base + static_cast<uint32_t>(y * Params::bg_map_w_tiles + x);
+            if (off < ram_size) ram[off] = static_cast<uint8_t>(1 + (x * 7 + y * 3) % 12);
+        }
+    }
+
+    // OAM: all entries on, in a 16x8 grid of sprites using tiles 13-17
+    for (int i = 0; i < Params::oam_entries; ++i) {
+        uint32_t off = Layout::oam_base + static_cast<uint32_t>(i * Params::bytes_per_oam);
+        if (off + 3 >= ram_size) break;
+
+        uint32_t x       = static_cast<uint32_t>(8 + (i % 16) * 19);
+        uint32_t y       = static_cast<uint32_t>(40 + (i / 16) * 20);
+        uint32_t tile    = static_cast<uint32_t>(13 + i % 5);
+        uint32_t palette = static_cast<uint32_t>(1 + i % 3);
+        uint32_t v = (1u << 31)
+                   | (static_cast<uint32_t>((i >> 1) & 1) << 30) // vflip
+                   | (static_cast<uint32_t>(i & 1) << 29)        // hflip
+                   | (palette << 26)
+                   | (tile << 17)
+                   | (y << 9)
+                   | x;
+        ram[off + 0] = static_cast<uint8_t>(v & 0xFF);
+        ram[off + 1] = static_cast<uint8_t>((v >> 8) & 0xFF);
+        ram[off + 2] = static_cast<uint8_t>((v >> 16) & 0xFF);
+        ram[off + 3] = static_cast<uint8_t>((v >> 24) & 0xFF);
+    }
+}
+
+void load_stress(std::vector<uint8_t>& ram) {
+    load_stress(ram.data(), ram.size());
+}
+
+void load_world(uint8_t* ram, std::size_t ram_size, uint16_t scroll_x, uint16_t scroll_y) {
+    load(ram, ram_size);
+    if (!ram || ram_size == 0) return;
+
+    // Rolling ground with gaps, brick rows and clouds, built from the demo tiles
+    constexpr int world_w = 256, world_h = 64;
+    for (int x = 0; x < world_w; ++x) {
+        const int ground = 20 + (x / 16) % 5 - ((x / 40) % 2) * 3;
+        const bool gap   = x % 37 >= 34;
+        for (int y = 0; y < world_h; ++y) {
+            uint8_t tile = 0;
+            if (!gap && y == ground) {
+                tile = 1;
+            } else if (!gap && y > ground) {
+                tile = 2;
+            } else if (y == ground - 4 && x % 23 >= 19) {
+                tile = (x % 23 == 21) ? 4 : 3;
+            } else if (y == 6 + (x / 29) % 4 && x % 29 < 2) {
+                tile = static_cast<uint8_t>(5 + x % 29);
+            }
+            uint32_t off = Layout::world_map_base + static_cast<uint32_t>(y * world_w + x);
+            if (off < ram_size) ram[off] = tile;
+        }
+    }
+
+    ppu_regs::Regs regs;
+    regs.word[ppu_regs::CTRL]     = ppu_regs::CTRL_WORLD_MAP;
+    regs.word[ppu_regs::SCROLL_X] = scroll_x;
+    regs.word[ppu_regs::SCROLL_Y] = scroll_y;
+    regs.word[ppu_regs::WORLD_W]  = world_w;
+    regs.word[ppu_regs::WORLD_H]  = world_h;
+    regs.word[ppu_regs::WORLD_LO] = static_cast<uint16_t>(Layout::world_map_base);
+    regs.word[ppu_regs::WORLD_HI] = static_cast<uint16_t>(Layout::world_map_base >> 16);
+    regs.store(ram, ram_size);
+}
+
+void load_world(std::vector<uint8_t>& ram, uint16_t scroll_x, uint16_t scroll_y) {
+    load_world(ram.data(), ram.size(), scroll_x, scroll_y);
+}
+
+void enable_tile_remap(uint8_t* ram, std::size_t ram_size) {
+    if (!ram || ram_size == 0) return;
+
+    for (int t = 0; t < ppu_regs::remap_entries; ++t) {
+        uint32_t off = Layout::remap_base + static_cast<uint32_t>(t);
+        if (off < ram_size) ram[off] = static_cast<uint8_t>(t);
+    }
+    ppu_regs::Regs regs = ppu_regs::Regs::from_ram(ram, ram_size);
+    regs.word[ppu_regs::CTRL] |= ppu_regs::CTRL_TILE_REMAP;
+    regs.store(ram, ram_size);
+}
+
+void enable_tile_remap(std::vector<uint8_t>& ram) {
+    enable_tile_remap(ram.data(), ram.size());
+}
+
+void enable_sprite_anim(uint8_t* ram, std::size_t ram_size, uint8_t desc) {
+    if (!ram || ram_size == 0) return;
+
+    for (int i = 0; i < Params::oam_entries; ++i) {
+        uint32_t off = Layout::anim_base + static_cast<uint32_t>(i);
+        if (off < ram_size) ram[off] = desc;
+    }
+    ppu_regs::Regs regs = ppu_regs::Regs::from_ram(ram, ram_size);
+    regs.word[ppu_regs::CTRL] |= ppu_regs::CTRL_SPRITE_ANIM;
+    regs.store(ram, ram_size);
+}
+
+void enable_sprite_anim(std::vector<uint8_t>& ram, uint8_t desc) {
+    enable_sprite_anim(ram.data(), ram.size(), desc);
+}
+
+void set_base(uint8_t* ram, std::size_t ram_size, int reg, uint32_t addr) {
+    if (!ram || ram_size == 0 || reg < ppu_regs::PALETTE_BASE || reg > ppu_regs::OAM_BASE) return;
+
+    ppu_regs::Regs regs = ppu_regs::Regs::from_ram(ram, ram_size);
+    regs.word[reg] = ppu_regs::base_word(addr);
+    regs.store(ram, ram_size);
+}
+
+void set_base(std::vector<uint8_t>& ram, int reg, uint32_t addr) {
+    set_base(ram.data(), ram.size(), reg, addr);
+}
+
+void enable_present_on_demand(uint8_t* ram, std::size_t ram_size) {
+    if (!ram || ram_size == 0) return;
+
+    ppu_regs::Regs regs = ppu_regs::Regs::from_ram(ram, ram_size);
+    regs.word[ppu_regs::CTRL] |= ppu_regs::CTRL_PRESENT;
+    regs.word[ppu_regs::PRESENT] = 1;
+    regs.store(ram, ram_size);
+}
+
+void enable_present_on_demand(std::vector<uint8_t>& ram) {
+    enable_present_on_demand(ram.data(), ram.size());
+}
+
+void enable_te_sync(uint8_t* ram, std::size_t ram_size) {
+    if (!ram || ram_size == 0) return;
+
+    ppu_regs::Regs regs = ppu_regs::Regs::from_ram(ram, ram_size);
+    regs.word[ppu_regs::CTRL] |= ppu_regs::CTRL_TE_SYNC;
+    regs.store(ram, ram_size);
+}
+
+void enable_te_sync(std::vector<uint8_t>& ram) {
+    enable_te_sync(ram.data(), ram.size());
+}
+
+void enable_color_cycle(uint8_t* ram, std::size_t ram_size, int range, uint16_t reg) {
+    if (!ram || ram_size == 0 || range < 0 || range >= ppu_regs::cycle_ranges) return;
+
+    ppu_regs::Regs regs = ppu_regs::Regs::from_ram(ram, ram_size);
+    regs.word[ppu_regs::CTRL] |= ppu_regs::CTRL_COLOR_CYCLE;
+    regs.word[ppu_regs::CYCLE0 + range] = reg;
+    regs.store(ram, ram_size);
+}
+
+void enable_color_cycle(std::vector<uint8_t>& ram, int range, uint16_t reg) {
+    enable_color_cycle(ram.data(), ram.size(), range, reg);
+}
+
+void load_enemies(uint8_t* ram, std::size_t ram_size) {
+    load_stress(ram, ram_size);
+    if (!ram || ram_size == 0) return;
+
+    for (int i = 0; i < Params::oam_entries; ++i) {
+        uint32_t off = Layout::oam_base + static_cast<uint32_t>(i * Params::bytes_per_oam);
+        if (off + 3 >= ram_size) break;
+
+        uint32_t x = static_cast<uint32_t>(8 + (i % 16) * 19);
+        uint32_t y = static_cast<uint32_t>(40 + (i / 16) * 20);
+        uint32_t v = (1u << 31)
+                   | (static_cast<uint32_t>(i & 1) << 29) // hflip: facing left or right
+                   | (2u << 26)                            // enemy palette
+                   | (15u << 17)
+                   | (y << 9)
+                   | x;
+        ram[off + 0] = static_cast<uint8_t>(v & 0xFF);
+        ram[off + 1] = static_cast<uint8_t>((v >> 8) & 0xFF);
+        ram[off + 2] = static_cast<uint8_t>((v >> 16) & 0xFF);
+        ram[off + 3] = static_cast<uint8_t>((v >> 24) & 0xFF);
+
+        uint32_t desc = Layout::anim_base + static_cast<uint32_t>(i);
+        if (desc < ram_size) ram[desc] = ppu_regs::anim_desc(2, 4 + i % 8);
+    }
+}
+
+void load_enemies(std::vector<uint8_t>& ram) {
+    load_enemies(ram.data(), ram.size());
+}
+
 } // namespace vram_init
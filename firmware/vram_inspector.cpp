@@ -0,0 +1,402 @@
+#include "vram_inspector.h"
+#include "ppu_regs.h"
+
+#include "Vppu.h"
+#include "Vppu___024root.h"
+
+#include <cstring>
+
+namespace vram_inspect {
+
+using vram_init::Params;
+
+// -----------------------------------------------------------------------------
+// Layout of the panels (pixels)
+// -----------------------------------------------------------------------------
+
+static constexpr int tile_sheet_cols = 32;
+static constexpr int tile_sheet_rows = Sizes::tiles / tile_sheet_cols;
+static constexpr int bg_scale        = 3;
+static constexpr int ui_scale        = 4;
+static constexpr int swatch          = 8;
+static constexpr int side_gap        = 12;
+static constexpr int title_h         = 14;
+static constexpr int panel_gap       = 6;
+static constexpr int oam_max_rows    = 16;
+static constexpr int oam_row_h       = 10;
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+static inline uint16_t read16le(const uint8_t* src) {
+    return static_cast<uint16_t>(src[0] | (src[1] << 8));
+}
+
+static inline uint32_t read32le(const uint8_t* src) {
+    return static_cast<uint32_t>(src[0])
+         | (static_cast<uint32_t>(src[1]) << 8)
+         | (static_cast<uint32_t>(src[2]) << 16)
+         | (static_cast<uint32_t>(src[3]) << 24);
+}
+
+static inline Color color_from_rgb12(uint16_t c) {
+    return Color{
+        static_cast<unsigned char>(((c >> 8) & 0xF) * 17),
+        static_cast<unsigned char>(((c >> 4) & 0xF) * 17),
+        static_cast<unsigned char>((c & 0xF) * 17),
+        255
+    };
+}
+
+// Distinct false colour per tile index; 0 (sky) stays black
+static inline Color color_from_tile_idx(uint8_t idx) {
+    if (idx == 0) return Color{0, 0, 0, 255};
+    return Color{
+        static_cast<unsigned char>(64 + ((idx * 73) & 0xBF)),
+        static_cast<unsigned char>(64 + ((idx * 151) & 0xBF)),
+        static_cast<unsigned char>(64 + ((idx * 199) & 0xBF)),
+        255
+    };
+}
+
+static void copy_region(uint8_t* dst, const uint8_t* ram, std::size_t ram_size, uint32_t base, uint32_t len) {
+    std::memset(dst, 0, len);
+    if (base >= ram_size) return;
+    uint32_t clamped = (base + len > ram_size) ? static_cast<uint32_t>(ram_size - base) : len;
+    std::memcpy(dst, ram + base, clamped);
+}
+
+// -----------------------------------------------------------------------------
+// Snapshot
+// -----------------------------------------------------------------------------
+
+void Snapshot::from_ram(const uint8_t* ram, std::size_t ram_size) {
+    const ppu_regs::Regs regs = ppu_regs::Regs::from_ram(ram, ram_size);
+
+    for (int p = 0; p < Params::palette_count; ++p) {
+        for (int c = 0; c < Params::colors_per_palette; ++c) {
+            uint32_t off = regs.palette_base() + static_cast<uint32_t>((p * Params::colors_per_palette + c) * Params::bytes_per_color);
+            palette[p][c] = (off + 1 < ram_size) ? (read16le(ram + off) & 0xFFF) : 0;
+        }
+    }
+
+    copy_region(tiles, ram, ram_size, regs.tile_base(), Sizes::tile_bytes);
+    world_map = regs.world_map();
+    if (world_map) {
+        std::memset(bg_map, 0, sizeof(bg_map));
+        for (int wy = 0; wy < ppu_regs::window_h(); ++wy) {
+            for (int wx = 0; wx < ppu_regs::window_w(); ++wx) {
+                bg_map[wy * Params::bg_map_w_tiles + wx] = regs.world_tile(ram, ram_size, wx, wy);
+            }
+        }
+    } else {
+        copy_region(bg_map, ram, ram_size, regs.bg_map_base(), Sizes::bg_cells);
+    }
+    copy_region(ui_map, ram, ram_size, regs.ui_map_base(), Sizes::ui_cells);
+
+    for (int i = 0; i < Params::oam_entries; ++i) {
+        uint32_t off = regs.oam_base() + static_cast<uint32_t>(i * Params::bytes_per_oam);
+        oam[i] = (off + 3 < ram_size) ? read32le(ram + off) : 0;
+    }
+}
+
+void Snapshot::from_ppu(const Vppu& ppu) {
+    const Vppu___024root* root = ppu.rootp;
+
+    for (int p = 0; p < Params::palette_count; ++p) {
+        for (int c = 0; c < Params::colors_per_palette; ++c) {
+            palette[p][c] = root->ppu__DOT__palette[p][c] & 0xFFF;
+        }
+    }
+    for (int i = 0; i < Sizes::tile_bytes; ++i) tiles[i]  = root->ppu__DOT__tile_memory[i];
+    for (int i = 0; i < Sizes::bg_cells; ++i)   bg_map[i] = root->ppu__DOT__bg_tile_map[i];
+    for (int i = 0; i < Sizes::ui_cells; ++i)   ui_map[i] = root->ppu__DOT__ui_tile_map[i];
+    for (int i = 0; i < Params::oam_entries; ++i) oam[i] = root->ppu__DOT__oam[i];
+}
+
+// -----------------------------------------------------------------------------
+// Inspector
+// -----------------------------------------------------------------------------
+
+Inspector::Inspector(int refresh_interval)
+    : refresh_interval(refresh_interval > 0 ? refresh_interval : 1) {
+    from_ram_snap = new Snapshot();
+    from_ppu_snap = new Snapshot();
+    std::memset(tile_diff, 0, sizeof(tile_diff));
+    std::memset(palette_diff, 0, sizeof(palette_diff));
+    std::memset(bg_diff, 0, sizeof(bg_diff));
+    std::memset(ui_diff, 0, sizeof(ui_diff));
+    std::memset(oam_diff, 0, sizeof(oam_diff));
+}
+
+Inspector::~Inspector() {
+    if (textures_ready) {
+        for (int s = 0; s < 2; ++s) {
+            UnloadTexture(tile_texture[s]);
+            UnloadTexture(bg_texture[s]);
+            UnloadTexture(ui_texture[s]);
+            UnloadImage(tile_image[s]);
+            UnloadImage(bg_image[s]);
+            UnloadImage(ui_image[s]);
+        }
+    }
+    delete from_ram_snap;
+    delete from_ppu_snap;
+}
+
+void Inspector::handle_input() {
+    static constexpr int keys[PANEL_COUNT] = { KEY_F1, KEY_F2, KEY_F3, KEY_F4, KEY_F5 };
+    for (int p = 0; p < PANEL_COUNT; ++p) {
+        if (IsKeyPressed(keys[p])) {
+            visible[p] = !visible[p];
+            frame_counter = 0; // refresh right away when a panel opens
+        }
+    }
+}
+
+bool Inspector::any_visible() const {
+    for (int p = 0; p < PANEL_COUNT; ++p) {
+        if (visible[p]) return true;
+    }
+    return false;
+}
+
+void Inspector::update(const uint8_t* ram, std::size_t ram_size, const Vppu& ppu) {
+    if (!any_visible()) return;
+
+    if (frame_counter == 0) {
+        capture(ram, ram_size, ppu);
+        rebuild_images();
+    }
+    frame_counter = (frame_counter + 1) % refresh_interval;
+}
+
+void Inspector::capture(const uint8_t* ram, std::size_t ram_size, const Vppu& ppu) {
+    const Snapshot& a = *from_ram_snap;
+    const Snapshot& b = *from_ppu_snap;
+
+    from_ram_snap->from_ram(ram, ram_size);
+    from_ppu_snap->from_ppu(ppu);
+
+    for (int p = 0; p < PANEL_COUNT; ++p) diff_count[p] = 0;
+
+    for (int t = 0; t < Sizes::tiles; ++t) {
+        int off = t * Params::bytes_per_tile;
+        tile_diff[t] = std::memcmp(a.tiles + off, b.tiles + off, Params::bytes_per_tile) != 0;
+        diff_count[PANEL_TILES] += tile_diff[t];
+    }
+    for (int p = 0; p < Params::palette_count; ++p) {
+        for (int c = 0; c < Params::colors_per_palette; ++c) {
+            palette_diff[p][c] = a.palette[p][c] != b.palette[p][c];
+            diff_count[PANEL_PALETTES] += palette_diff[p][c];
+        }
+    }
+    for (int i = 0; i < Sizes::bg_cells; ++i) {
+        // In world map mode the PPU only refreshes the window's cells; the
+        // others keep whatever an earlier refresh left there
+        const bool in_window = !a.world_map || (i % Params::bg_map_w_tiles < ppu_regs::window_w() &&
+                                                i / Params::bg_map_w_tiles < ppu_regs::window_h());
+        bg_diff[i] = in_window && a.bg_map[i] != b.bg_map[i];
+        diff_count[PANEL_BG_MAP] += bg_diff[i];
+    }
+    for (int i = 0; i < Sizes::ui_cells; ++i) {
+        ui_diff[i] = a.ui_map[i] != b.ui_map[i];
+        diff_count[PANEL_UI_MAP] += ui_diff[i];
+    }
+    for (int i = 0; i < Params::oam_entries; ++i) {
+        oam_diff[i] = a.oam[i] != b.oam[i];
+        diff_count[PANEL_OAM] += oam_diff[i];
+    }
+}
+
+void Inspector::rebuild_images() {
+    if (!textures_ready) {
+        for (int s = 0; s < 2; ++s) {
+            tile_image[s]   = GenImageColor(tile_sheet_cols * Params::tile_dim_px, tile_sheet_rows * Params::tile_dim_px, BLACK);
+            tile_texture[s] = LoadTextureFromImage(tile_image[s]);
+            bg_image[s]     = GenImageColor(Params::bg_map_w_tiles, Params::bg_map_h_tiles, BLACK);
+            bg_texture[s]   = LoadTextureFromImage(bg_image[s]);
+            ui_image[s]     = GenImageColor(Params::ui_map_w_tiles, Params::ui_map_h_tiles, BLACK);
+            ui_texture[s]   = LoadTextureFromImage(ui_image[s]);
+        }
+        textures_ready = true;
+    }
+
+    const Snapshot* snaps[2] = { from_ram_snap, from_ppu_snap };
+
+    for (int s = 0; s < 2; ++s) {
+        const Snapshot& snap = *snaps[s];
+
+        // Tile sheet, 4bpp as a grey ramp (palette independent)
+        Color* px = static_cast<Color*>(tile_image[s].data);
+        const int sheet_w = tile_image[s].width;
+        for (int t = 0; t < Sizes::tiles; ++t) {
+            int tx = (t % tile_sheet_cols) * Params::tile_dim_px;
+            int ty = (t / tile_sheet_cols) * Params::tile_dim_px;
+            for (int ly = 0; ly < Params::tile_dim_px; ++ly) {
+                for (int lx = 0; lx < Params::tile_dim_px; ++lx) {
+                    uint8_t byte = snap.tiles[t * Params::bytes_per_tile + ly * 4 + (lx >> 1)];
+                    uint8_t val  = (lx & 1) ? (byte & 0xF) : (byte >> 4);
+                    unsigned char g = static_cast<unsigned char>(val * 17);
+                    px[(ty + ly) * sheet_w + tx + lx] = Color{g, g, g, 255};
+                }
+            }
+        }
+        UpdateTexture(tile_texture[s], tile_image[s].data);
+
+        Color* bg = static_cast<Color*>(bg_image[s].data);
+        for (int i = 0; i < Sizes::bg_cells; ++i) bg[i] = color_from_tile_idx(snap.bg_map[i]);
+        UpdateTexture(bg_texture[s], bg_image[s].data);
+
+        Color* ui = static_cast<Color*>(ui_image[s].data);
+        for (int i = 0; i < Sizes::ui_cells; ++i) ui[i] = color_from_tile_idx(snap.ui_map[i]);
+        UpdateTexture(ui_texture[s], ui_image[s].data);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Drawing
+// -----------------------------------------------------------------------------
+
+static const char* panel_names[Inspector::PANEL_COUNT] = {
+    "F1 tiles", "F2 palettes", "F3 BG map", "F4 UI map", "F5 OAM"
+};
+
+static void draw_title(int x, int y, const char* name, int diffs) {
+    DrawText(TextFormat("%s   RAM | PPU", name), x, y, 10, WHITE);
+    if (diffs > 0) {
+        DrawText(TextFormat("%d diff", diffs), x + 200, y, 10, RED);
+    }
+}
+
+int Inspector::panel_height(Panel p) const {
+    switch (p) {
+        case PANEL_TILES:    return tile_sheet_rows * Params::tile_dim_px;
+        case PANEL_PALETTES: return Params::palette_count * swatch;
+        case PANEL_BG_MAP:   return Params::bg_map_h_tiles * bg_scale;
+        case PANEL_UI_MAP:   return Params::ui_map_h_tiles * ui_scale;
+        case PANEL_OAM:      return (oam_max_rows + 1) * oam_row_h;
+        default:             return 0;
+    }
+}
+
+void Inspector::draw(int x, int y) const {
+    if (!textures_ready) return;
+
+    for (int p = 0; p < PANEL_COUNT; ++p) {
+        if (!visible[p]) continue;
+
+        Panel panel = static_cast<Panel>(p);
+        int h = title_h + panel_height(panel);
+        DrawRectangle(x - 4, y - 2, 560, h + 4, Fade(BLACK, 0.8f));
+        draw_title(x, y, panel_names[p], diff_count[p]);
+
+        int body_y = y + title_h;
+        switch (panel) {
+            case PANEL_TILES:    draw_tiles(x, body_y);    break;
+            case PANEL_PALETTES: draw_palettes(x, body_y); break;
+            case PANEL_BG_MAP:   draw_bg_map(x, body_y);   break;
+            case PANEL_UI_MAP:   draw_ui_map(x, body_y);   break;
+            case PANEL_OAM:      draw_oam(x, body_y);      break;
+            default: break;
+        }
+        y += h + panel_gap;
+    }
+}
+
+void Inspector::draw_tiles(int x, int y) const {
+    const int w = tile_sheet_cols * Params::tile_dim_px;
+    for (int s = 0; s < 2; ++s) {
+        int ox = x + s * (w + side_gap);
+        DrawTextureEx(tile_texture[s], Vector2{(float)ox, (float)y}, 0.0f, 1.0f, WHITE);
+        for (int t = 0; t < Sizes::tiles; ++t) {
+            if (!tile_diff[t]) continue;
+            DrawRectangleLines(ox + (t % tile_sheet_cols) * Params::tile_dim_px,
+                               y + (t / tile_sheet_cols) * Params::tile_dim_px,
+                               Params::tile_dim_px, Params::tile_dim_px, RED);
+        }
+    }
+}
+
+void Inspector::draw_palettes(int x, int y) const {
+    const Snapshot* snaps[2] = { from_ram_snap, from_ppu_snap };
+    const int w = Params::colors_per_palette * swatch;
+    for (int s = 0; s < 2; ++s) {
+        int ox = x + s * (w + side_gap);
+        for (int p = 0; p < Params::palette_count; ++p) {
+            for (int c = 0; c < Params::colors_per_palette; ++c) {
+                int sx = ox + c * swatch;
+                int sy = y + p * swatch;
+                DrawRectangle(sx, sy, swatch, swatch, color_from_rgb12(snaps[s]->palette[p][c]));
+                if (palette_diff[p][c]) DrawRectangleLines(sx, sy, swatch, swatch, RED);
+            }
+        }
+    }
+}
+
+void Inspector::draw_bg_map(int x, int y) const {
+    const int w = Params::bg_map_w_tiles * bg_scale;
+    for (int s = 0; s < 2; ++s) {
+        int ox = x + s * (w + side_gap);
+        DrawTextureEx(bg_texture[s], Vector2{(float)ox, (float)y}, 0.0f, (float)bg_scale, WHITE);
+        for (int i = 0; i < Sizes::bg_cells; ++i) {
+            if (!bg_diff[i]) continue;
+            DrawRectangleLines(ox + (i % Params::bg_map_w_tiles) * bg_scale,
+                               y + (i / Params::bg_map_w_tiles) * bg_scale,
+                               bg_scale, bg_scale, RED);
+        }
+    }
+}
+
+void Inspector::draw_ui_map(int x, int y) const {
+    const int w = Params::ui_map_w_tiles * ui_scale;
+    for (int s = 0; s < 2; ++s) {
+        int ox = x + s * (w + side_gap);
+        DrawTextureEx(ui_texture[s], Vector2{(float)ox, (float)y}, 0.0f, (float)ui_scale, WHITE);
+        for (int i = 0; i < Sizes::ui_cells; ++i) {
+            if (!ui_diff[i]) continue;
+            DrawRectangleLines(ox + (i % Params::ui_map_w_tiles) * ui_scale,
+                               y + (i / Params::ui_map_w_tiles) * ui_scale,
+                               ui_scale, ui_scale, RED);
+        }
+    }
+}
+
+// One row per entry that is enabled on either side or differs
+void Inspector::draw_oam(int x, int y) const {
+    DrawText("idx    x    y  tile pal hv   |    x    y  tile pal hv", x, y, 10, LIGHTGRAY);
+
+    int row = 0;
+    int hidden = 0;
+    for (int i = 0; i < Params::oam_entries; ++i) {
+        uint32_t a = from_ram_snap->oam[i];
+        uint32_t b = from_ppu_snap->oam[i];
+        if (!(a >> 31) && !(b >> 31) && !oam_diff[i]) continue;
+
+        if (row >= oam_max_rows) {
+            hidden++;
+            continue;
+        }
+
+        auto fmt = [](uint32_t o) {
+            return TextFormat("%s %3u  %3u  %3u  %u  %c%c",
+                              (o >> 31) ? "on " : "off",
+                              o & 0x1FF, (o >> 9) & 0xFF, (o >> 17) & 0x1FF, (o >> 26) & 0x7,
+                              ((o >> 29) & 1) ? 'h' : '-', ((o >> 30) & 1) ? 'v' : '-');
+        };
+
+        int ry = y + (row + 1) * oam_row_h;
+        Color c = oam_diff[i] ? RED : WHITE;
+        DrawText(TextFormat("%3d", i), x, ry, 10, c);
+        DrawText(fmt(a), x + 30, ry, 10, c);
+        DrawText(fmt(b), x + 250, ry, 10, c);
+        row++;
+    }
+
+    if (hidden > 0) {
+        DrawText(TextFormat("+%d more", hidden), x + 480, y, 10, GRAY);
+    }
+}
+
+} // namespace vram_inspect
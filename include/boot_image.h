@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+//
+// Boot flash images
+//
+// What boot_loader.sv streams from the SPI flash into SRAM after reset:
+// segments of an 8-byte header followed by their payload, from flash
+// address 0, ended by a header with length 0.
+//
+//   0-2  SRAM destination byte address, little endian, even
+//   3-5  length in bytes, little endian, even
+//   6    flags, bit 0 = LZ compressed payload
+//   7    reserved, 0 (erased flash, FFh, also ends the image)
+//
+// The LZ payload is LZSS with a 4 KB window: a flag byte, LSB first, for up
+// to 8 items, 1 = a literal byte, 0 = a match of two bytes, distance - 1 in
+// 12 bits (low byte, then the high nibble in bits 7:4) and length - 3 in
+// bits 3:0. Matches stay inside their segment and the payload ends where
+// the segment's length is reached.
+//
+
+namespace boot_image {
+
+constexpr std::size_t header_bytes = 8;
+constexpr int         window_bytes = 4096;
+constexpr int         min_match    = 3;
+constexpr int         max_match    = 18;
+
+struct Segment {
+    uint32_t             dest = 0;
+    std::vector<uint8_t> data;
+};
+
+// The parts of a RAM image worth loading: runs of non-zero bytes, aligned
+// and padded to even. Gaps shorter than `min_gap` bytes are bridged, as a
+// zero run that short costs less flash than another header.
+std::vector<Segment> from_ram(const uint8_t* ram, std::size_t size, std::size_t min_gap = 64);
+
+std::vector<uint8_t> lz_compress(const uint8_t* data, std::size_t size);
+
+// Expands `out_size` bytes; false if `src` runs out or a match reaches
+// before the start. `consumed` gets the payload bytes used.
+bool lz_decompress(const uint8_t* src, std::size_t src_size, std::size_t out_size, std::vector<uint8_t>& out,
+                   std::size_t* consumed = nullptr);
+
+// Flash image of `segments`. With `compress`, each segment is stored LZ
+// compressed where that is smaller.
+std::vector<uint8_t> build(const std::vector<Segment>& segments, bool compress);
+
+// What the boot loader leaves in `ram`. False on a malformed image.
+bool load(const uint8_t* flash, std::size_t flash_size, uint8_t* ram, std::size_t ram_size);
+
+} // namespace boot_image
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+
+//
+// Bus arbitration protocol monitor
+//
+// Cheap per-cycle checks on the 68000 arbitration pins, run by every
+// Mud16System tick. Sampled right after the rising edge, i.e. the PPU's new
+// outputs together with the CPU pins the PPU just sampled.
+//
+
+struct BusMonitor {
+    enum Violation {
+        NONE,
+        BGACK_WHILE_AS_LOW,   // PPU took the bus while the CPU still had a cycle running
+        BGACK_WITHOUT_BG,     // PPU took the bus without a grant
+        OE_CONFLICT,          // CPU level shifters not matching bus ownership
+        DRIVE_WITHOUT_BUS,    // PPU strobed memory without owning the bus
+        REQUEST_STARVED,      // BR held for starvation_limit cycles without BGACK
+        VIOLATION_COUNT
+    };
+
+    // A refresh request has to be granted well within one frame
+    static constexpr uint32_t starvation_limit = 100000;
+
+    uint64_t  counts[VIOLATION_COUNT] = {};
+    Violation first       = NONE;
+    uint64_t  first_cycle = 0;
+
+    uint8_t   prev_bgack_n = 1;
+    uint32_t  br_wait      = 0;
+
+    bool ok() const { return first == NONE; }
+
+    uint64_t total() const {
+        uint64_t n = 0;
+        for (int v = NONE + 1; v < VIOLATION_COUNT; ++v) n += counts[v];
+        return n;
+    }
+
+    inline void check(uint8_t br_n, uint8_t bg_n, uint8_t as_n, uint8_t bgack_n,
+                      uint8_t oe_n, bool mem_strobe, uint64_t cycle) {
+        // BGACK asserted on this edge
+        if (!bgack_n && prev_bgack_n) {
+            if (!as_n) flag(BGACK_WHILE_AS_LOW, cycle);
+            if (bg_n)  flag(BGACK_WITHOUT_BG, cycle);
+        }
+        prev_bgack_n = bgack_n;
+
+        // OE low lets the CPU drive; it must be exactly "CPU is master"
+        if (oe_n == bgack_n) flag(OE_CONFLICT, cycle);
+
+        if (mem_strobe && (bgack_n || !oe_n)) flag(DRIVE_WITHOUT_BUS, cycle);
+
+        if (!br_n && bgack_n) {
+            if (++br_wait == starvation_limit) flag(REQUEST_STARVED, cycle);
+        } else {
+            br_wait = 0;
+        }
+    }
+
+    static const char* name(Violation v) {
+        switch (v) {
+            case NONE:               return "none";
+            case BGACK_WHILE_AS_LOW: return "bgack-while-as-low";
+            case BGACK_WITHOUT_BG:   return "bgack-without-bg";
+            case OE_CONFLICT:        return "oe-conflict";
+            case DRIVE_WITHOUT_BUS:  return "drive-without-bus";
+            case REQUEST_STARVED:    return "request-starved";
+            default:                 return "?";
+        }
+    }
+
+private:
+    inline void flag(Violation v, uint64_t cycle) {
+        counts[v]++;
+        if (first == NONE) {
+            first       = v;
+            first_cycle = cycle;
+        }
+    }
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//
+// Bus cycle profiler
+//
+// Where the CPU's bus time goes, sampled from the arbitration pins every PPU
+// cycle: the CPU owns the bus, waits after the PPU's bus request for its
+// grant to take effect, or is off the bus while the PPU fetches. Fetch
+// cycles are charged to the SRAM address of the access they belong to,
+// handshake included, and through a SymbolTable to a named region.
+//
+// There is no 68000 model behind the arbitration stand-in, so the CPU's
+// own cycles have no PC; the per-address counts are the PPU's fetches.
+//
+
+namespace cycle_profile {
+
+// SRAM address -> name; an address belongs to the closest symbol at or
+// below it
+class SymbolTable {
+public:
+    void add(uint32_t addr, const std::string& name);
+
+    // "ADDR NAME" or nm-style "ADDR TYPE NAME" lines, ADDR in hex; blank
+    // lines and lines starting with # are skipped. False if the file can't
+    // be read.
+    bool load(const std::string& path);
+
+    const std::string& lookup(uint32_t addr) const;
+    uint32_t address_of(uint32_t addr) const; // the symbol's own address
+
+private:
+    std::vector<std::pair<uint32_t, std::string>> symbols; // sorted by address
+    std::string unknown = "?";
+};
+
+// The PPU's regions as the registers in `ram` place them
+SymbolTable default_symbols(const uint8_t* ram, std::size_t ram_size);
+
+class Profiler {
+public:
+    double ppu_clock_hz = 27.0e6;
+    double cpu_clock_hz = 12.0e6;
+
+    uint64_t cycles      = 0; // PPU cycles sampled
+    uint64_t cpu_run     = 0; // BR and BGACK high: the CPU has the bus
+    uint64_t cpu_request = 0; // BR low, BGACK high: CPU finishing its cycle and granting
+    uint64_t cpu_fetch   = 0; // BGACK low: the PPU fetches
+
+    // One PPU cycle, with the pins as Mud16System::tick() leaves them
+    inline void sample(uint8_t br_n, uint8_t bgack_n, bool mem_strobe, uint32_t mem_addr) {
+        cycles++;
+        if (!bgack_n) {
+            cpu_fetch++;
+            pending++;
+            if (mem_strobe) {
+                by_addr[mem_addr] += pending;
+                pending   = 0;
+                last_addr = mem_addr;
+            }
+            return;
+        }
+        // The hold's release handshake goes to its last access
+        if (pending) {
+            by_addr[last_addr] += pending;
+            pending = 0;
+        }
+        if (br_n) {
+            cpu_run++;
+        } else {
+            cpu_request++;
+        }
+    }
+
+    // Charges a hold still open at the end of the run
+    void finish();
+
+    // Folded stacks ("cpu;stall;ppu_fetch;tiles 1234"), PPU cycles as the
+    // weight, for flamegraph.pl / speedscope / inferno
+    void write_folded(FILE* out, const SymbolTable& symbols) const;
+
+    // Cycle split, fetch cycles per symbol and the `top` busiest addresses
+    void print(FILE* out, const SymbolTable& symbols, int top) const;
+
+private:
+    std::vector<std::pair<std::string, uint64_t>> by_symbol(const SymbolTable& symbols) const;
+
+    std::unordered_map<uint32_t, uint64_t> by_addr;
+    uint64_t pending   = 0; // fetch cycles not charged to an access yet
+    uint32_t last_addr = 0;
+};
+
+} // namespace cycle_profile
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+//
+// Analytic frame budget for ppu.sv
+//
+// Derives refresh bus hold, render cycles and the CPU's share of the bus
+// from the PPU parameters, the memory latency and the region sizes the
+// refresh FSM copies (vram_init::Params), without simulating anything.
+// The cycle counts follow ppu.sv's FSMs; the arbitration handshake assumes
+// the fixed CPU stand-in of Mud16System and may come out a cycle short when
+// AS was low at the moment BR went out. mud16_budget checks the estimate
+// against the linked PPU variants.
+//
+// Two things in ppu.sv shape the numbers:
+// - each refresh read takes 4 + latency cycles of FSM handshaking, an OAM
+//   entry 7 + 2 * latency on the 16-bit path (two reads) and 4 + latency on
+//   the 32-bit one
+// - the mem_refreshed pulse restarts the refresh FSM while need_mem_refresh
+//   is still high, so a second refresh runs during the visible frame.
+//   Only the first one stalls the pixel counter; if a refresh outlasts the
+//   visible frame, the pixel counter waits for it instead and there is
+//   only one refresh per frame.
+//
+
+namespace frame_budget {
+
+struct Config {
+    int width            = 320; // DISP_WIDTH
+    int height           = 240; // DISP_HEIGHT
+    int max_objects      = 128; // MAX_OBJECTS
+    int bus_read_latency = 1;   // BUS_READ_LATENCY
+    int mem_width        = 16;  // MEM_WIDTH, 16 or 32
+    int grant_delay      = 4;   // CPU stand-in: cycles from BR low to BG low
+    bool world_map       = false; // ppu_regs::CTRL_WORLD_MAP set in SRAM
+    bool tile_remap      = false; // ppu_regs::CTRL_TILE_REMAP set in SRAM
+    bool sprite_anim     = false; // ppu_regs::CTRL_SPRITE_ANIM set in SRAM
+
+    double clock_hz   = 27.0e6;
+    double frame_rate = 60.0;
+
+    // ppu.sv parameter overrides as in MUD16_PPU_VARIANTS ("NAME=value,...").
+    // Unknown names are ignored; returns false on a malformed entry.
+    bool apply(const std::string& params);
+
+    uint64_t budget_cycles() const { return static_cast<uint64_t>(clock_hz / frame_rate + 0.5); }
+};
+
+struct Estimate {
+    // Refresh (one pass of the refresh FSM)
+    uint64_t reads            = 0; // 16-bit bus reads
+    uint64_t read_cycles      = 0; // first read issued to DONE
+    uint64_t refresh_hold     = 0; // cycles with BGACK low
+    uint64_t refresh_period   = 0; // refresh start to the pixel counter moving again
+    int      refreshes        = 0; // per frame
+
+    // Frame
+    uint64_t render_cycles    = 0; // one pixel per cycle
+    uint64_t stall_cycles     = 0; // pixel counter held at (0,0)
+    uint64_t frame_cycles     = 0;
+    uint64_t bus_hold_cycles  = 0; // per frame
+
+    double   cpu_share        = 0.0; // fraction of cycles the CPU owns the bus
+    double   fps              = 0.0; // at Config::clock_hz
+    uint64_t budget_cycles    = 0;   // per frame at Config::frame_rate
+    bool     fits             = false;
+
+    void print(FILE* out) const;
+};
+
+Estimate estimate(const Config& config);
+
+// Relative difference of a simulated value from the estimate
+double drift(double estimated, double simulated);
+
+} // namespace frame_budget
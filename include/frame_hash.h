@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+//
+// Fast non-cryptographic 64-bit hash for comparing frames (XXH64 style
+// rounds over four lanes). Only used to detect changes, never for security.
+//
+
+namespace frame_hash {
+
+static constexpr uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t prime3 = 0x165667B19E3779F9ULL;
+static constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t lane_round(uint64_t acc, uint64_t lane) {
+    acc += lane * prime2;
+    acc  = rotl(acc, 31);
+    return acc * prime1;
+}
+
+static inline uint64_t merge(uint64_t acc, uint64_t v) {
+    acc ^= lane_round(0, v);
+    return acc * prime1 + prime4;
+}
+
+inline uint64_t hash64(const uint8_t* data, std::size_t len, uint64_t seed = 0) {
+    const uint8_t* p   = data;
+    const uint8_t* end = data + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v1 = seed + prime1 + prime2;
+        uint64_t v2 = seed + prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - prime1;
+        do {
+            v1 = lane_round(v1, read64(p)); p += 8;
+            v2 = lane_round(v2, read64(p)); p += 8;
+            v3 = lane_round(v3, read64(p)); p += 8;
+            v4 = lane_round(v4, read64(p)); p += 8;
+        } while (p + 32 <= end);
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = merge(h, v1);
+        h = merge(h, v2);
+        h = merge(h, v3);
+        h = merge(h, v4);
+    } else {
+        h = seed + prime5;
+    }
+
+    h += static_cast<uint64_t>(len);
+
+    while (p + 8 <= end) {
+        h ^= lane_round(0, read64(p));
+        h  = rotl(h, 27) * prime1 + prime4;
+        p += 8;
+    }
+    while (p < end) {
+        h ^= (*p) * prime5;
+        h  = rotl(h, 11) * prime1;
+        p++;
+    }
+
+    // Avalanche
+    h ^= h >> 33;
+    h *= prime2;
+    h ^= h >> 29;
+    h *= prime3;
+    h ^= h >> 32;
+    return h;
+}
+
+} // namespace frame_hash
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+//
+// ILI9488 display model
+//
+// The panel's side of the pixel interface: its own scan through GRAM at the
+// panel refresh rate, the TE (tearing effect) output and a tearing check.
+// The PPU's frame is the GRAM window, scanned one line per frame row after
+// `porch_lines` lines of vertical blanking; TE is high during the blanking
+// (TE mode 1, V-blank only).
+//
+// A refresh tears when the rows it scans don't all come from the same PPU
+// frame: some were written by a newer frame than others, or a row was being
+// written when the scan reached it. Stepped by Mud16System once per PPU
+// cycle; tb_top.sv has the same counters and check.
+//
+
+struct Ili9488Panel {
+    // 27 MHz / (244 lines * 1844 cycles) = 60.0 Hz
+    static constexpr int line_cycles = 1844;
+    static constexpr int porch_lines = 4;
+
+    int width;
+    int rows;
+
+    uint64_t refreshes = 0; // complete scans of the GRAM window
+    uint64_t tears     = 0; // of those, scans that showed more than one frame
+
+    explicit Ili9488Panel(int width_, int rows_)
+        : width(width_), rows(rows_), row_frame(static_cast<std::size_t>(rows_), 0) {}
+
+    int  lines() const { return rows + porch_lines; }
+    bool te() const { return line < porch_lines; }
+
+    // Cycles until TE rises, 0 while it is high
+    uint64_t cycles_to_te() const {
+        if (te()) return 0;
+        return static_cast<uint64_t>(lines() - line) * line_cycles - line_cycle;
+    }
+
+    // One PPU clock cycle of the panel's scan
+    inline void tick() {
+        if (line_cycle == 0 && line >= porch_lines) scan_row(line - porch_lines);
+        if (++line_cycle == line_cycles) {
+            line_cycle = 0;
+            if (++line == lines()) {
+                line = 0;
+                refreshes++;
+                if (torn) tears++;
+                scan_frame = 0;
+                torn       = false;
+            }
+        }
+    }
+
+    // A pixel of the PPU's frame arrived (pixel_sync)
+    inline void write_pixel() {
+        if (++write_x < width) return;
+        write_x = 0;
+        row_frame[static_cast<std::size_t>(write_row)] = write_frame;
+        if (++write_row == rows) {
+            write_row = 0;
+            write_frame++;
+        }
+    }
+
+    // The PPU was reset: its next pixel is the first of a frame
+    void restart_writes() {
+        write_x   = 0;
+        write_row = 0;
+    }
+
+    // Scan time passed without simulation (frame cache replay). The frame
+    // it stood for is the one already in GRAM, so nothing can tear.
+    void skip(uint64_t cycles) {
+        const uint64_t frame_cycles = static_cast<uint64_t>(lines()) * line_cycles;
+        uint64_t pos = static_cast<uint64_t>(line) * line_cycles + line_cycle + cycles;
+        if (pos >= frame_cycles && torn) tears++;
+        if (pos >= frame_cycles) {
+            refreshes += pos / frame_cycles;
+            pos %= frame_cycles;
+            scan_frame = 0;
+            torn       = false;
+        }
+        line       = static_cast<int>(pos / line_cycles);
+        line_cycle = static_cast<int>(pos % line_cycles);
+    }
+
+private:
+    void scan_row(int row) {
+        const uint32_t f = row_frame[static_cast<std::size_t>(row)];
+        if (write_x != 0 && write_row == row) torn = true;
+        if (f == 0) return; // never written
+        if (scan_frame != 0 && f != scan_frame) torn = true;
+        scan_frame = f;
+    }
+
+    // Scan position
+    int line       = 0;
+    int line_cycle = 0;
+
+    // Refresh in progress: frame of the rows scanned so far (0 = none yet)
+    uint32_t scan_frame = 0;
+    bool     torn       = false;
+
+    // Write side: frame id of each complete GRAM row (0 = never written)
+    std::vector<uint32_t> row_frame;
+    int      write_x     = 0;
+    int      write_row   = 0;
+    uint32_t write_frame = 1;
+};
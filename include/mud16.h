@@ -0,0 +1,73 @@
+#ifndef MUD16_H
+#define MUD16_H
+
+/*
+ * libmud16 C API
+ *
+ * Stable C interface to the mud-16 system model (Verilated PPU + SRAM and CPU
+ * bus stand-ins) for test harnesses and scripted runners. The calls are batch
+ * oriented: step a whole frame or a block of cycles per call, then read the
+ * framebuffer or RAM, so foreign callers cross the boundary once per frame
+ * rather than once per cycle.
+ *
+ * Functions returning int return 0 on success and -1 on error.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(MUD16_BUILD_SHARED)
+#define MUD16_API __declspec(dllexport)
+#elif defined(_WIN32) && defined(MUD16_USE_SHARED)
+#define MUD16_API __declspec(dllimport)
+#elif defined(__GNUC__)
+#define MUD16_API __attribute__((visibility("default")))
+#else
+#define MUD16_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MUD16_API_VERSION 1
+
+typedef struct mud16_system mud16_system;
+
+typedef struct mud16_stats {
+    uint64_t cycles;          /* PPU clock cycles simulated */
+    uint64_t frames;          /* complete frames captured */
+    uint64_t pixels;          /* pixels captured */
+    uint64_t bus_hold_cycles; /* cycles the PPU held the shared bus */
+} mud16_stats;
+
+MUD16_API int mud16_api_version(void);
+
+/* Creates a system with the demo scene loaded and the PPU out of reset */
+MUD16_API mud16_system* mud16_create(void);
+MUD16_API void          mud16_destroy(mud16_system* sys);
+
+/* Pulses reset; call after loading an image */
+MUD16_API void mud16_reset(mud16_system* sys);
+
+/* Copies a RAM image to `offset` (use 0 for a full VRAM image) */
+MUD16_API int mud16_load_image(mud16_system* sys, const uint8_t* data, size_t size, uint32_t offset);
+
+/* Batch stepping */
+MUD16_API void mud16_step_cycles(mud16_system* sys, uint64_t cycles);
+MUD16_API void mud16_step_frames(mud16_system* sys, uint32_t frames);
+
+/* RGBA8 framebuffer, valid until the next step call or mud16_destroy */
+MUD16_API const uint8_t* mud16_framebuffer(const mud16_system* sys, int* width, int* height);
+
+MUD16_API size_t mud16_ram_size(const mud16_system* sys);
+MUD16_API int    mud16_read_ram(const mud16_system* sys, uint32_t addr, uint8_t* dst, size_t len);
+MUD16_API int    mud16_write_ram(mud16_system* sys, uint32_t addr, const uint8_t* src, size_t len);
+
+MUD16_API void mud16_get_stats(const mud16_system* sys, mud16_stats* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MUD16_H */
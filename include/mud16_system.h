@@ -0,0 +1,198 @@
+#pragma once
+
+#include "Vppu.h"
+#include "verilated.h"
+#include "bus_monitor.h"
+#include "ili9488_panel.h"
+#include "spi_flash.h"
+#include "vram_fingerprint.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// System Simulation Class
+//
+// The Verilated PPU together with the C++ stand-ins for the shared SRAM and
+// the 68000's side of the bus arbitration. Used by the raylib front end and,
+// through the C API in mud16.h, by headless tools.
+//
+// A template over the Verilated model so PPU variants built with other
+// parameters (--prefix Vppu_<name>, see mud16_variants.h) share it; the
+// member definitions live in mud16_system_impl.h.
+// -----------------------------------------------------------------------------
+
+struct Mud16Stats {
+    uint64_t cycles          = 0; // PPU clock cycles simulated
+    uint64_t frames          = 0; // complete frames, captured into the framebuffer or held
+    uint64_t pixels          = 0; // pixels captured (pixel_sync pulses)
+    uint64_t bus_hold_cycles = 0; // cycles with BGACK asserted (PPU owns the bus)
+    uint64_t cached_frames   = 0; // frames reused from the frame cache instead of simulated
+
+    // Present on demand (CTRL_PRESENT): frames the PPU neither rendered nor
+    // sent to the display, and the bus hold spent on them (register reads)
+    uint64_t held_frames          = 0;
+    uint64_t held_bus_hold_cycles = 0;
+
+    // The display (Ili9488Panel): its refreshes, and those that showed parts
+    // of more than one frame
+    uint64_t panel_refreshes = 0;
+    uint64_t tear_events     = 0;
+
+    // Cycles jumped over while the PPU only waited for TE (set_idle_skip)
+    uint64_t idle_skipped_cycles = 0;
+
+    // Boot from flash (load_flash): cycles the boot loader ran and the
+    // flash bytes it read
+    uint64_t boot_cycles      = 0;
+    uint64_t flash_bytes_read = 0;
+};
+
+// Timing of the 68000 side of the arbitration. The defaults reproduce the
+// fixed stand-in; with `randomize` every delay is drawn from `seed` within
+// the given ranges (used by mud16_fuzz).
+struct CpuBusConfig {
+    bool     randomize       = false;
+    uint64_t seed            = 1;
+    int      grant_delay_min = 4;  // cycles from BR low to BG low
+    int      grant_delay_max = 4;
+    int      cycle_len_max   = 1;  // AS low time of one CPU bus cycle (1..max)
+    int      idle_len_max    = 3;  // AS high gap between bus cycles (0..max)
+};
+
+template <class Model, int Width = 320, int Height = 240>
+class BasicMud16System {
+public:
+    static constexpr int width    = Width;
+    static constexpr int height   = Height;
+    static constexpr int ram_size = 512 * 1024;
+
+    std::unique_ptr<VerilatedContext> context;
+    Model* ppu;
+    std::vector<uint8_t> ram;
+    uint64_t tick_count = 0;
+
+    // CPU Simulation State
+    bool cpu_using_bus = true;
+    int  cpu_grant_delay_counter = 0;
+    CpuBusConfig cpu;
+
+    // Always-on arbitration checks
+    BusMonitor monitor;
+
+    // The display behind pixel_sync, drives the PPU's TE input
+    Ili9488Panel panel{Width, Height};
+
+    // The boot flash on the PPU's SPI pins
+    SpiFlash flash;
+
+    // Loads the demo scene from vram_init
+    BasicMud16System();
+    ~BasicMud16System();
+
+    BasicMud16System(const BasicMud16System&) = delete;
+    BasicMud16System& operator=(const BasicMud16System&) = delete;
+
+    void init_ram_pattern();
+
+    // Replaces the CPU timing and restarts its random stream
+    void configure_cpu(const CpuBusConfig& config);
+    void reset();
+
+    // Run one clock cycle
+    void tick();
+
+    // Fast tick mode: one eval per cycle instead of two (see tick()). Only
+    // valid while every ppu.sv output is registered, so check it with
+    // tick_check::run() / mud16_tickcheck first. Returns false if the
+    // Verilated model doesn't expose the clock edge state needed for it.
+    static bool fast_tick_supported();
+    bool set_fast_tick(bool enable);
+    bool fast_tick() const { return fast; }
+
+    // Frame cache: step_frames() reuses the previous frame instead of
+    // simulating it while the VRAM fingerprint is unchanged. A frame is only
+    // reused after two simulated frames from the same VRAM came out identical
+    // (same pixels, cycles and bus hold), since a frame also depends on PPU
+    // state left over from the one before. Not used with random CPU timing
+    // or while the PPU animates sprites, cycles colours, decides by itself
+    // which frames to present or waits for the display's TE
+    // (CTRL_SPRITE_ANIM, CTRL_COLOR_CYCLE, CTRL_PRESENT, CTRL_TE_SYNC).
+    void set_frame_cache(bool enable);
+    bool frame_cache() const { return cache_enabled; }
+
+    // Idle skip: while the PPU waits for the display's TE with nothing else
+    // going on (its te_idle output), step_cycles() and step_frames() jump to
+    // the cycle TE rises. Nothing in the PPU changes over such a wait, so the
+    // result is the same as simulating it: only the display's scan and the
+    // CPU stand-in's AS pattern move on. Not used with random CPU timing.
+    void set_idle_skip(bool enable) { idle_skip = enable; }
+    bool idle_skip_enabled() const { return idle_skip; }
+
+    // Batch stepping; pixels are captured into the framebuffer as they come out
+    void step_cycles(uint64_t cycles);
+    void step_frames(uint32_t frames);
+
+    // RGBA8, width * height * 4 bytes. Holds the last complete frame plus
+    // whatever part of the current one has been drawn so far.
+    const uint8_t* framebuffer() const { return fb.data(); }
+
+    // Copies `size` bytes into RAM at `offset`; false if out of range
+    bool load_image(const uint8_t* data, std::size_t size, uint32_t offset = 0);
+
+    // Puts a boot image (boot_image.h) into the flash and sets the boot
+    // strap, so the next reset() streams it into RAM before the first
+    // frame. RAM is left as it is. False if it exceeds SpiFlash::capacity.
+    bool load_flash(const uint8_t* data, std::size_t size);
+    bool read_ram(uint32_t addr, uint8_t* dst, std::size_t len) const;
+    bool write_ram(uint32_t addr, const uint8_t* src, std::size_t len);
+
+    // Writes straight into `ram` bypass the frame cache's write tracking and
+    // have to be reported here
+    void ram_written(uint32_t addr, std::size_t len) { vram_fp.note_write(addr, len); }
+
+    Mud16Stats stats() const;
+
+private:
+    void simulate_cpu_arbitration();
+    void simulate_cpu_arbitration_random();
+    uint32_t cpu_random(int lo, int hi);
+    void simulate_memory();
+    void capture_pixel();
+    void end_frame();
+    void step_frame_cached();
+    uint64_t skip_idle(uint64_t max_cycles);
+
+    // Randomized CPU state
+    uint64_t cpu_rng            = 1;
+    int      cpu_grant_target   = 0;
+    int      cpu_as_remaining   = 0;
+    int      cpu_idle_remaining = 0;
+
+    bool fast      = false;
+    bool idle_skip = false;
+
+    struct FrameCache {
+        bool     valid       = false;
+        bool     confirmed   = false; // last two simulated frames matched
+        uint64_t fingerprint = 0;     // VRAM the frame was rendered from
+        uint64_t hash        = 0;
+        uint64_t cycles      = 0;
+        uint64_t bus_hold    = 0;
+    };
+    bool            cache_enabled = false;
+    FrameCache      cache;
+    VramFingerprint vram_fp;
+
+    std::vector<uint8_t> fb;
+    int        fb_cursor = 0;
+    bool       frame_pixels = false;  // some pixel of the current frame came out
+    uint64_t   frame_hold_start = 0;  // bus_hold_cycles at the last vblank
+    Mud16Stats counters;
+};
+
+// The PPU as configured in ppu.sv, used everywhere outside the variant runner
+extern template class BasicMud16System<Vppu>;
+using Mud16System = BasicMud16System<Vppu>;
@@ -0,0 +1,438 @@
+#pragma once
+
+// Member definitions of BasicMud16System. Included by the translation units
+// that instantiate it: mud16_system.cpp for the default Vppu model and the
+// generated mud16_variants.cpp for the PPU variants. Fast tick needs the
+// model's root header (V<prefix>___024root.h) included before this one.
+
+#include "mud16_system.h"
+#include "frame_hash.h"
+#include "vram_init_data.h"
+
+#include <algorithm>
+#include <cstring>
+
+template <class Model, int Width, int Height>
+BasicMud16System<Model, Width, Height>::BasicMud16System()
+    : context(new VerilatedContext) {
+    ppu = new Model{context.get()};
+    ram.resize(ram_size);
+    memset(ram.data(), 0, ram_size);
+    vram_init::load(ram);
+
+    fb.assign(static_cast<std::size_t>(width) * height * 4, 0);
+
+    // Initial pin states
+    ppu->clk = 0;
+    ppu->reset = 1;
+    ppu->cpu_bg_n = 1; // Not granted
+    ppu->cpu_as_n = 1; // Address strobe inactive
+    ppu->te = 0;
+    ppu->boot_flash = 0;
+    ppu->spi_miso = 1;
+    ppu->eval();
+}
+
+template <class Model, int Width, int Height>
+BasicMud16System<Model, Width, Height>::~BasicMud16System() {
+    ppu->final();
+    delete ppu;
+}
+
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::init_ram_pattern() {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int addr = (y * width + x) * 4;
+            if (addr + 3 < ram_size) {
+                ram[addr]     = (uint8_t)(x & 0xFF);
+                ram[addr + 1] = (uint8_t)(y & 0xFF);
+                ram[addr + 2] = (uint8_t)((x + y) & 0xFF);
+                ram[addr + 3] = 0xFF;
+            }
+        }
+    }
+    vram_fp.invalidate();
+}
+
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::configure_cpu(const CpuBusConfig& config) {
+    cpu = config;
+    cpu_rng = config.seed ? config.seed : 1;
+    cpu_grant_delay_counter = 0;
+    cpu_grant_target   = cpu_random(cpu.grant_delay_min, cpu.grant_delay_max);
+    cpu_as_remaining   = 0;
+    cpu_idle_remaining = 0;
+}
+
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::reset() {
+    ppu->reset = 1;
+    tick();
+    tick();
+    ppu->reset = 0;
+    fb_cursor = 0;
+    panel.restart_writes();
+    frame_pixels = false;
+    frame_hold_start = counters.bus_hold_cycles;
+    cache = FrameCache{};
+}
+
+template <class Model, int Width, int Height>
+bool BasicMud16System<Model, Width, Height>::fast_tick_supported() {
+#ifdef MUD16_CLK_PREV
+    return true;
+#else
+    return false;
+#endif
+}
+
+template <class Model, int Width, int Height>
+bool BasicMud16System<Model, Width, Height>::set_fast_tick(bool enable) {
+    if (enable && !fast_tick_supported()) return false;
+    fast = enable;
+
+    // Settle on the low clock so the next rising eval sees an edge either way
+    ppu->clk = 0;
+    ppu->eval();
+    return true;
+}
+
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::tick() {
+    // 1. Rising Edge
+    //
+    // In fast mode the falling-edge eval of the previous cycle was skipped.
+    // ppu.sv only has posedge logic and registered outputs, so that eval
+    // changed nothing we read; the inputs set since then are settled by this
+    // eval before the edge. Verilator still remembers clk as high, though,
+    // so tell it the clock was low to get the posedge triggered.
+    ppu->clk = 1;
+#ifdef MUD16_CLK_PREV
+    if (fast) ppu->rootp->MUD16_CLK_PREV = 0;
+#endif
+    ppu->eval();
+
+    monitor.check(ppu->ppu_br_n, ppu->cpu_bg_n, ppu->cpu_as_n, ppu->ppu_bgack_n,
+                  ppu->cpu_bus_oe_n, ppu->mem_read || ppu->mem_write, tick_count);
+
+    // 2. Simulate External Hardware (CPU & RAM)
+    if (cpu.randomize) {
+        simulate_cpu_arbitration_random();
+    } else {
+        simulate_cpu_arbitration();
+    }
+    simulate_memory();
+    ppu->spi_miso = flash.tick(ppu->spi_cs_n, ppu->spi_sck, ppu->spi_mosi);
+    if (ppu->booting) counters.boot_cycles++;
+    ppu->te = panel.te();
+    panel.tick();
+
+    // 3. Falling Edge
+    ppu->clk = 0;
+    if (!fast) ppu->eval();
+
+    if (ppu->ppu_bgack_n == 0) counters.bus_hold_cycles++;
+    if (ppu->pixel_sync) capture_pixel();
+    if (ppu->vblank) end_frame();
+
+    tick_count++;
+}
+
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::step_cycles(uint64_t cycles) {
+    for (uint64_t i = 0; i < cycles; i++) {
+        if (idle_skip) {
+            i += skip_idle(cycles - i);
+            if (i == cycles) break;
+        }
+        tick();
+    }
+}
+
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::step_frames(uint32_t frames) {
+    const uint64_t target = counters.frames + frames;
+    while (counters.frames < target) {
+        if (cache_enabled && fb_cursor == 0 && !cpu.randomize) {
+            step_frame_cached();
+        } else {
+            if (idle_skip) skip_idle(UINT64_MAX);
+            tick();
+        }
+    }
+}
+
+// The ticks of an idle TE wait, minus the PPU evals: te stays low, the CPU
+// stand-in sees BR high and pulses AS, the memory model floats. Stops where
+// TE goes high, so the next tick() hands the PPU its rising edge.
+template <class Model, int Width, int Height>
+uint64_t BasicMud16System<Model, Width, Height>::skip_idle(uint64_t max_cycles) {
+    if (!ppu->te_idle || ppu->te || cpu.randomize) return 0;
+    const uint64_t n = std::min(panel.cycles_to_te(), max_cycles);
+    if (n == 0) return 0;
+
+    // The monitor still sees every skipped cycle: BR, BGACK and OE sit at
+    // "CPU owns the bus", no strobes, AS as the stand-in drives it
+    for (uint64_t i = 0; i < n; i++) {
+        const uint8_t as_n = i == 0 ? ppu->cpu_as_n : ((tick_count + i - 1) % 4 == 0 ? 0 : 1);
+        monitor.check(ppu->ppu_br_n, 1, as_n, ppu->ppu_bgack_n, ppu->cpu_bus_oe_n, false, tick_count + i);
+        panel.tick();
+    }
+    tick_count += n;
+    counters.idle_skipped_cycles += n;
+
+    ppu->cpu_bg_n  = 1;
+    ppu->cpu_as_n  = ((tick_count - 1) % 4 == 0) ? 0 : 1;
+    ppu->mem_rdata = 0;
+    cpu_grant_delay_counter = 0;
+    return n;
+}
+
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::set_frame_cache(bool enable) {
+    cache_enabled = enable;
+    cache = FrameCache{};
+}
+
+// One whole frame, starting at the first pixel
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::step_frame_cached() {
+    const std::size_t frame_bytes = static_cast<std::size_t>(width) * height * 4;
+    const uint64_t    frame       = counters.frames;
+
+    // Frames that change by themselves can't be reused
+    if (VramFingerprint::animates(ram.data(), ram.size())) {
+        cache = FrameCache{};
+        while (counters.frames == frame) {
+            if (idle_skip) skip_idle(UINT64_MAX);
+            tick();
+        }
+        return;
+    }
+
+    const uint64_t    fp          = vram_fp.value(ram.data(), ram.size());
+
+    if (cache.confirmed && fp == cache.fingerprint) {
+        // fb still holds the cached frame. The PPU is left where the last
+        // simulated frame ended, which is where this one would end too: its
+        // own counters only move while animates() is true, and the register
+        // words it latches are in the fingerprint. What does move on is
+        // outside it, so those pins are set as the skipped frame's last
+        // tick() would have: TE from the panel's scan, and AS from the
+        // stand-in's pattern (tick_count % 4) while the CPU owns the bus.
+        // The bus monitor doesn't see the skipped cycles.
+        tick_count += cache.cycles;
+        panel.skip(cache.cycles - 1);
+        ppu->te = panel.te();
+        panel.tick();
+        if (ppu->ppu_br_n && ppu->ppu_bgack_n) ppu->cpu_as_n = ((tick_count - 1) % 4 == 0) ? 0 : 1;
+
+        counters.bus_hold_cycles += cache.bus_hold;
+        counters.pixels += static_cast<uint64_t>(width) * height;
+        counters.frames++;
+        counters.cached_frames++;
+        frame_hold_start = counters.bus_hold_cycles;
+        return;
+    }
+
+    const uint64_t start_cycles = tick_count;
+    const uint64_t start_hold   = counters.bus_hold_cycles;
+    while (counters.frames == frame) {
+        tick();
+    }
+
+    FrameCache next;
+    next.valid       = true;
+    next.fingerprint = fp;
+    next.hash        = frame_hash::hash64(fb.data(), frame_bytes);
+    next.cycles      = tick_count - start_cycles;
+    next.bus_hold    = counters.bus_hold_cycles - start_hold;
+    next.confirmed   = cache.valid && cache.fingerprint == next.fingerprint && cache.hash == next.hash &&
+                       cache.cycles == next.cycles && cache.bus_hold == next.bus_hold;
+    cache = next;
+}
+
+template <class Model, int Width, int Height>
+bool BasicMud16System<Model, Width, Height>::load_image(const uint8_t* data, std::size_t size, uint32_t offset) {
+    return write_ram(offset, data, size);
+}
+
+template <class Model, int Width, int Height>
+bool BasicMud16System<Model, Width, Height>::load_flash(const uint8_t* data, std::size_t size) {
+    if (!data || size > SpiFlash::capacity) return false;
+    flash.data.assign(data, data + size);
+    ppu->boot_flash = 1;
+    return true;
+}
+
+template <class Model, int Width, int Height>
+bool BasicMud16System<Model, Width, Height>::read_ram(uint32_t addr, uint8_t* dst, std::size_t len) const {
+    if (!dst || addr > ram.size() || len > ram.size() - addr) return false;
+    std::memcpy(dst, ram.data() + addr, len);
+    return true;
+}
+
+template <class Model, int Width, int Height>
+bool BasicMud16System<Model, Width, Height>::write_ram(uint32_t addr, const uint8_t* src, std::size_t len) {
+    if (!src || addr > ram.size() || len > ram.size() - addr) return false;
+    std::memcpy(ram.data() + addr, src, len);
+    vram_fp.note_write(addr, len);
+    return true;
+}
+
+template <class Model, int Width, int Height>
+Mud16Stats BasicMud16System<Model, Width, Height>::stats() const {
+    Mud16Stats s = counters;
+    s.cycles = tick_count;
+    s.panel_refreshes = panel.refreshes;
+    s.tear_events     = panel.tears;
+    s.flash_bytes_read = flash.bytes_read;
+    return s;
+}
+
+// -----------------------------------------------------------------------------
+// External hardware
+// -----------------------------------------------------------------------------
+
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::capture_pixel() {
+    uint8_t* px = fb.data() + static_cast<std::size_t>(fb_cursor) * 4;
+    px[0] = ppu->pixel_r;
+    px[1] = ppu->pixel_g;
+    px[2] = ppu->pixel_b;
+    px[3] = 255;
+    panel.write_pixel();
+    counters.pixels++;
+    frame_pixels = true;
+
+    if (++fb_cursor == width * height) {
+        fb_cursor = 0;
+        counters.frames++;
+    }
+}
+
+// A frame without any pixels was held by present on demand; the panel keeps
+// the last one, and so does fb
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::end_frame() {
+    if (!frame_pixels) {
+        counters.frames++;
+        counters.held_frames++;
+        counters.held_bus_hold_cycles += counters.bus_hold_cycles - frame_hold_start;
+    }
+    frame_pixels     = false;
+    frame_hold_start = counters.bus_hold_cycles;
+}
+
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::simulate_cpu_arbitration() {
+    // --- CPU Logic ---
+
+    // If PPU requests bus (BR low)
+    if (ppu->ppu_br_n == 0) {
+        // CPU takes some time to finish current instruction and release bus
+        if (cpu_grant_delay_counter < 4) {
+            cpu_grant_delay_counter++;
+        } else {
+            // Grant the bus
+            ppu->cpu_bg_n = 0;
+
+            // Release AS (Address Strobe) to indicate bus cycle finished
+            ppu->cpu_as_n = 1;
+        }
+    } else {
+        // No request, reset logic
+        ppu->cpu_bg_n = 1;
+        cpu_grant_delay_counter = 0;
+
+        // If PPU is not master, CPU is master, so it might be pulsing AS
+        if (ppu->ppu_bgack_n == 1) {
+            // Simulate CPU activity (randomly pulsing AS)
+            ppu->cpu_as_n = (tick_count % 4 == 0) ? 0 : 1;
+        }
+    }
+}
+
+// xorshift64*, uniform in [lo, hi]
+template <class Model, int Width, int Height>
+uint32_t BasicMud16System<Model, Width, Height>::cpu_random(int lo, int hi) {
+    if (hi <= lo) return static_cast<uint32_t>(lo);
+    cpu_rng ^= cpu_rng >> 12;
+    cpu_rng ^= cpu_rng << 25;
+    cpu_rng ^= cpu_rng >> 27;
+    uint64_t r = cpu_rng * 0x2545F4914F6CDD1DULL;
+    return static_cast<uint32_t>(lo + (r >> 32) % static_cast<uint64_t>(hi - lo + 1));
+}
+
+// Same protocol as the fixed stand-in, with random grant latency and random
+// CPU bus cycles. A cycle already running when BG goes out is finished
+// first, which is what the PPU has to wait for.
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::simulate_cpu_arbitration_random() {
+    if (ppu->ppu_br_n == 0) {
+        if (cpu_grant_delay_counter < cpu_grant_target) {
+            cpu_grant_delay_counter++;
+        } else {
+            ppu->cpu_bg_n = 0;
+        }
+    } else if (ppu->cpu_bg_n == 0 || cpu_grant_delay_counter != 0) {
+        ppu->cpu_bg_n = 1;
+        cpu_grant_delay_counter = 0;
+        cpu_grant_target = cpu_random(cpu.grant_delay_min, cpu.grant_delay_max);
+    }
+
+    if (ppu->ppu_bgack_n == 0) {
+        // Off the bus while the PPU is master
+        ppu->cpu_as_n = 1;
+        cpu_as_remaining = 0;
+    } else if (cpu_as_remaining > 0) {
+        ppu->cpu_as_n = 0;
+        cpu_as_remaining--;
+    } else if (ppu->cpu_bg_n == 0) {
+        // Granted: no new bus cycles until BGACK is released
+        ppu->cpu_as_n = 1;
+    } else if (cpu_idle_remaining > 0) {
+        ppu->cpu_as_n = 1;
+        cpu_idle_remaining--;
+    } else {
+        cpu_as_remaining   = static_cast<int>(cpu_random(1, cpu.cycle_len_max)) - 1;
+        cpu_idle_remaining = static_cast<int>(cpu_random(0, cpu.idle_len_max));
+        ppu->cpu_as_n = 0;
+    }
+}
+
+template <class Model, int Width, int Height>
+void BasicMud16System<Model, Width, Height>::simulate_memory() {
+    // Only respond if PPU is actually driving the bus
+    if (ppu->ppu_bgack_n == 0 && ppu->cpu_bus_oe_n == 1) {
+
+        if (ppu->mem_read) {
+            uint32_t addr = ppu->mem_addr;
+            // mem_rdata is MEM_WIDTH bits: one SRAM chip, or both at 32
+            if constexpr (sizeof(ppu->mem_rdata) >= 4) {
+                if (addr + 3 < ram_size) {
+                    ppu->mem_rdata = ram[addr]
+                                   | (ram[addr + 1] << 8)
+                                   | (ram[addr + 2] << 16)
+                                   | (ram[addr + 3] << 24);
+                }
+            } else if (addr + 1 < ram_size) {
+                ppu->mem_rdata = static_cast<uint16_t>(ram[addr] | (ram[addr + 1] << 8));
+            }
+        }
+
+        if (ppu->mem_write) {
+            uint32_t addr = ppu->mem_addr;
+            uint32_t data = ppu->mem_wdata;
+            if (addr + 1 < ram_size) {
+                ram[addr]     = data & 0xFF; // 16 bit write
+                ram[addr + 1] = (data >> 8) & 0xFF;
+                vram_fp.note_write(addr, 2);
+            }
+        }
+    } else {
+        // Bus is floating or driven by CPU (we ignore CPU memory access for this sim)
+        ppu->mem_rdata = 0;
+    }
+}
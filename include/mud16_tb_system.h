@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Vtb_top.h"
+#include "verilated.h"
+#include "mud16_system.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// SV Testbench System
+//
+// Same system as Mud16System, but the SRAM, the CPU arbitration stand-in and
+// the framebuffer live inside the Verilated tb_top, so each cycle is one
+// clock eval with no pin traffic across the C++/model boundary. Uses the
+// fixed CPU timing only and has no BusMonitor.
+//
+// tb_top's counters and framebuffer take the PPU's outputs at the following
+// edge, one clock after Mud16System does, so stats() reports the cycles they
+// have seen and step_frames() ends one tick later on the same frame.
+// -----------------------------------------------------------------------------
+
+class Mud16TbSystem {
+public:
+    static constexpr int width    = Mud16System::width;
+    static constexpr int height   = Mud16System::height;
+    static constexpr int ram_size = Mud16System::ram_size;
+
+    std::unique_ptr<VerilatedContext> context;
+    Vtb_top* top;
+    uint64_t tick_count = 0;
+
+    // Loads the demo scene from vram_init
+    Mud16TbSystem();
+    ~Mud16TbSystem();
+
+    Mud16TbSystem(const Mud16TbSystem&) = delete;
+    Mud16TbSystem& operator=(const Mud16TbSystem&) = delete;
+
+    void reset();
+
+    // Run one clock cycle. tb_top is posedge-only, so with MUD16_TB_CLK_PREV
+    // (see CMakeLists.txt) the falling edge is not evaluated at all.
+    void tick();
+
+    void step_cycles(uint64_t cycles);
+    void step_frames(uint32_t frames);
+
+    // RGBA8 copy of the testbench framebuffer, converted on each call
+    const uint8_t* framebuffer() const;
+
+    bool load_image(const uint8_t* data, std::size_t size, uint32_t offset = 0);
+
+    // Same as Mud16System::load_flash(); the rest of the flash is erased
+    bool load_flash(const uint8_t* data, std::size_t size);
+    bool read_ram(uint32_t addr, uint8_t* dst, std::size_t len) const;
+    bool write_ram(uint32_t addr, const uint8_t* src, std::size_t len);
+
+    Mud16Stats stats() const;
+
+private:
+    mutable std::vector<uint8_t> fb_rgba;
+};
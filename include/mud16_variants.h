@@ -0,0 +1,35 @@
+#pragma once
+
+#include "mud16_system.h"
+
+#include <cstdint>
+#include <vector>
+
+//
+// PPU parameter variants linked into one binary. Each entry of
+// MUD16_PPU_VARIANTS in firmware/CMakeLists.txt is Verilated from ppu.sv with
+// its own -G overrides and --prefix Vppu_<name>, wrapped in a
+// BasicMud16System and registered here (generated mud16_variants.cpp).
+//
+
+namespace mud16_variants {
+
+struct Result {
+    Mud16Stats stats;
+    double     seconds    = 0.0; // wall time of step_frames(), i.e. eval cost
+    uint64_t   frame_hash = 0;
+};
+
+struct Variant {
+    const char* name;
+    const char* params;  // the -G overrides, "" for the ppu.sv defaults
+    int         width;
+    int         height;
+
+    // Loads `ram` into a fresh system, resets it and runs `frames` frames
+    Result (*run)(const std::vector<uint8_t>& ram, uint32_t frames);
+};
+
+const std::vector<Variant>& all();
+
+} // namespace mud16_variants
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+//
+// Minimal PNG writer for headless tools (no raylib / zlib dependency).
+// Data is stored uncompressed, which is fine for occasional debug dumps.
+//
+
+namespace png_writer {
+
+// Writes width * height RGBA8 pixels; returns false on I/O error
+bool write_rgba(const std::string& path, int width, int height, const uint8_t* rgba);
+
+} // namespace png_writer
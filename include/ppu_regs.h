@@ -0,0 +1,173 @@
+#pragma once
+
+#include "vram_init_data.h"
+
+#include <cstdint>
+#include <cstddef>
+
+//
+// PPU registers
+//
+// 16-bit words at vram_init::Layout::reg_base, read by the refresh FSM at the
+// start of every refresh, before the palettes (REG_MEM_OFFSET in ppu.sv).
+// All zero turns every feature off and keeps the default bases, but the
+// block is read whatever CTRL holds: word_count / RD_WORDS extra memory
+// reads per refresh, so refresh and frame timing are not those of the PPU
+// before it had registers.
+//
+
+namespace ppu_regs {
+
+enum Word : int {
+    CTRL       = 0,
+    SCROLL_X   = 1, // world map mode: top left of the screen in world pixels
+    SCROLL_Y   = 2,
+    WORLD_W    = 3, // world map size in tiles, one byte per tile, row-major
+    WORLD_H    = 4,
+    WORLD_LO   = 5, // world map byte address in SRAM, bits 15:0
+    WORLD_HI   = 6, // bits 19:16
+    PRESENT    = 7, // present on demand: change it to show a new frame
+    CYCLE0     = 8, // colour cycle ranges, see color_cycle()
+    CYCLE1     = 9,
+    PALETTE_BASE = 10, // region byte address / 16, 0 = the vram_init::Layout
+    TILE_BASE    = 11, // default; latched at vblank, see base()
+    BG_MAP_BASE  = 12,
+    UI_MAP_BASE  = 13,
+    OAM_BASE     = 14,
+    word_count = 16,
+};
+
+enum Ctrl : uint16_t {
+    // The refresh fetches the window of the world map under the scroll
+    // position instead of copying the 64x64 BG map
+    CTRL_WORLD_MAP = 1u << 0,
+
+    // BG and UI tile indices go through the 256-entry table at
+    // Layout::remap_base before the tile lookup (objects are not remapped)
+    CTRL_TILE_REMAP = 1u << 1,
+
+    // Objects animate by themselves from the descriptors at
+    // Layout::anim_base, advanced by the PPU at every vblank
+    CTRL_SPRITE_ANIM = 1u << 2,
+
+    // Palette entries rotate inside the CYCLE0/CYCLE1 ranges, stepped by the
+    // PPU at vblank
+    CTRL_COLOR_CYCLE = 1u << 3,
+
+    // The PPU only renders and sends a frame when PRESENT changed since the
+    // last one it presented; otherwise the panel keeps its image and the
+    // refresh stops after the registers
+    CTRL_PRESENT = 1u << 4,
+
+    // After the refresh, the first pixel of a frame waits for the display's
+    // TE to rise (start of its vertical blanking), so the frame's GRAM
+    // writes run ahead of the panel scan instead of crossing it
+    CTRL_TE_SYNC = 1u << 5,
+};
+
+constexpr int remap_entries = 256;
+
+// Sprite animation descriptor: the object draws OAM tile + frame, with
+// `frames` frames (1..8) shown for `vblanks` frames each (1..32). Writing a
+// different descriptor restarts the animation at frame 0; 0 is a still.
+constexpr uint8_t anim_desc(int frames, int vblanks) {
+    return static_cast<uint8_t>(((vblanks - 1) & 0x1F) << 3 | ((frames - 1) & 0x7));
+}
+constexpr int anim_frames(uint8_t desc) { return (desc & 7) + 1; }
+constexpr int anim_vblanks(uint8_t desc) { return (desc >> 3) + 1; }
+
+// Colour cycle range register: entries first..first+length-1 (length 2..16)
+// of `palette` rotate by one every `vblanks` frames (1..32). Colour index i
+// in the range is drawn with the entry (phase) places further on. A changed
+// register takes effect at the next vblank, from phase 0; 0 is off.
+constexpr int cycle_ranges = 2;
+
+constexpr uint16_t color_cycle(int palette, int first, int length, int vblanks) {
+    return static_cast<uint16_t>(((vblanks - 1) & 0x1F) << 11 | ((length - 1) & 0xF) << 7 |
+                                 (first & 0xF) << 3 | (palette & 7));
+}
+
+constexpr bool cycle_covers(uint16_t reg, int pal, int idx) {
+    const int first = (reg >> 3) & 0xF, span = (reg >> 7) & 0xF;
+    return span && pal == (reg & 7) && idx >= first && idx - first <= span;
+}
+
+// Colour index the PPU looks up for index `idx` of palette `pal`, with range
+// register `reg` at `phase`. Where ranges overlap, the last one wins.
+constexpr int cycle_index(uint16_t reg, int phase, int pal, int idx) {
+    if (!cycle_covers(reg, pal, idx)) return idx;
+    const int first = (reg >> 3) & 0xF, span = (reg >> 7) & 0xF;
+    int off = idx - first + phase;
+    if (off > span) off -= span + 1;
+    return (first + off) & 0xF;
+}
+
+// Base register value for a region at SRAM byte address `addr` (16-byte
+// aligned, below 1 MB)
+constexpr uint16_t base_word(uint32_t addr) { return static_cast<uint16_t>(addr >> 4); }
+
+// World map window fetched per refresh: the visible tiles plus one row and
+// column for the fine scroll (WIN_W / WIN_H in ppu.sv)
+constexpr int window_w(int disp_width = 320) { return disp_width / 8 + 1; }
+constexpr int window_h(int disp_height = 240) { return disp_height / 8 + 1; }
+
+struct Regs {
+    uint16_t word[word_count] = {};
+
+    static Regs from_ram(const uint8_t* ram, std::size_t size) {
+        Regs r;
+        for (int i = 0; i < word_count; i++) {
+            const std::size_t a = vram_init::Layout::reg_base + i * 2;
+            r.word[i] = a + 1 < size ? static_cast<uint16_t>(ram[a] | ram[a + 1] << 8) : 0;
+        }
+        return r;
+    }
+
+    void store(uint8_t* ram, std::size_t size) const {
+        for (int i = 0; i < word_count; i++) {
+            const std::size_t a = vram_init::Layout::reg_base + i * 2;
+            if (a + 1 >= size) break;
+            ram[a]     = static_cast<uint8_t>(word[i]);
+            ram[a + 1] = static_cast<uint8_t>(word[i] >> 8);
+        }
+    }
+
+    bool world_map() const { return word[CTRL] & CTRL_WORLD_MAP; }
+    bool tile_remap() const { return word[CTRL] & CTRL_TILE_REMAP; }
+    bool sprite_anim() const { return word[CTRL] & CTRL_SPRITE_ANIM; }
+    bool color_cycle() const { return word[CTRL] & CTRL_COLOR_CYCLE; }
+    bool present_on_demand() const { return word[CTRL] & CTRL_PRESENT; }
+    bool te_sync() const { return word[CTRL] & CTRL_TE_SYNC; }
+
+    // Where the refresh that starts at the next vblank reads a region. The
+    // second refresh of a frame keeps the bases of the first, so writes to
+    // a buffer that is not on screen never tear.
+    uint32_t base(Word reg, uint32_t fallback) const { return word[reg] ? uint32_t(word[reg]) << 4 : fallback; }
+    uint32_t palette_base() const { return base(PALETTE_BASE, vram_init::Layout::palette_base); }
+    uint32_t tile_base() const { return base(TILE_BASE, vram_init::Layout::tile_base); }
+    uint32_t bg_map_base() const { return base(BG_MAP_BASE, vram_init::Layout::bg_map_base); }
+    uint32_t ui_map_base() const { return base(UI_MAP_BASE, vram_init::Layout::ui_map_base); }
+    uint32_t oam_base() const { return base(OAM_BASE, vram_init::Layout::oam_base); }
+
+    int  fine_x() const { return world_map() ? word[SCROLL_X] & 7 : 0; }
+    int  fine_y() const { return world_map() ? word[SCROLL_Y] & 7 : 0; }
+
+    // SRAM byte address of window cell (wx, wy), wrapped to the 20-bit bus
+    // like ppu.sv. False if the cell lies outside the world (tile 0).
+    bool world_cell(int wx, int wy, uint32_t& addr) const {
+        const uint32_t col  = static_cast<uint16_t>((word[SCROLL_X] >> 3) + wx);
+        const uint32_t row  = static_cast<uint16_t>((word[SCROLL_Y] >> 3) + wy);
+        const uint32_t base = static_cast<uint32_t>(word[WORLD_HI] & 0xF) << 16 | word[WORLD_LO];
+        addr = (base + row * word[WORLD_W] + col) & 0xFFFFF;
+        return col < word[WORLD_W] && row < word[WORLD_H];
+    }
+
+    // The byte the refresh stores for window cell (wx, wy)
+    uint8_t world_tile(const uint8_t* ram, std::size_t size, int wx, int wy) const {
+        uint32_t addr = 0;
+        if (!world_cell(wx, wy, addr)) return 0;
+        return addr < size ? ram[addr] : 0;
+    }
+};
+
+} // namespace ppu_regs
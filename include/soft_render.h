@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ppu_regs.h"
+
+#include <cstdint>
+#include <cstddef>
+
+//
+// Software renderer for the mud-16 tile/OAM format
+//
+// Draws a frame from a RAM image the way ppu.sv is written to, without
+// simulating the bus: BG layer, the 128 OAM objects in order and the UI bars,
+// including the registered-state quirks of the object loop (object pixels
+// use the local_x/local_y/palette_idx registers left by the previous pixel)
+// and the sprite animation and colour cycle counters the PPU advances at
+// every vblank. Those quirks are modelled from reading the RTL; only the
+// scalar and batched renderers have been compared so far, and
+// `mud16_batch --verify K` is the check against Mud16System.
+//
+// render() is the scalar reference. render_batch() draws up to batch_lanes
+// independent scenes in lockstep over the same pixel coordinates, one scene
+// per SIMD lane (AVX2 when the CPU has it, otherwise lane by lane). Batches
+// with a world map fine scroll in any scene are drawn lane by lane too.
+//
+
+namespace soft_render {
+
+static constexpr int width       = 320;
+static constexpr int height      = 240;
+static constexpr int batch_lanes = 8;
+
+// The PPU's copies of VRAM, as the refresh FSM loads them
+struct Vram {
+    uint16_t palette[8][16];   // 12-bit RGB
+    uint8_t  tiles[16384];
+    uint8_t  bg_map[4096];     // in world map mode the fetched window, 64 cells per row
+    uint8_t  ui_map[400];
+    uint32_t oam[128];
+    ppu_regs::Regs regs;
+    uint8_t  remap[256];       // BG/UI tile remap, the identity while disabled
+    uint8_t  anim[128];        // sprite animation descriptors, zero while disabled
+
+    // Reads the regions where the PPU registers put them, as the refresh at
+    // vblank would (vram_init::Layout unless relocated)
+    static void from_ram(const uint8_t* ram, std::size_t ram_size, Vram& out);
+};
+
+// Object-loop registers carried from pixel to pixel and frame to frame, and
+// the sprite animation counters. The defaults are the state after reset.
+struct State {
+    uint8_t local_x     = 0;
+    uint8_t local_y     = 0;
+    uint8_t palette_idx = 0;
+
+    uint8_t anim_seen[128]  = {};
+    uint8_t anim_step[128]  = {};
+    uint8_t anim_frame[128] = {};
+
+    uint16_t cycle_seen[ppu_regs::cycle_ranges]  = {};
+    uint8_t  cycle_step[ppu_regs::cycle_ranges]  = {};
+    uint8_t  cycle_phase[ppu_regs::cycle_ranges] = {};
+};
+
+// One frame into `rgba` (width * height * 4 bytes)
+void render(const Vram& vram, State& state, uint8_t* rgba);
+
+// One frame for each of `count` (1..batch_lanes) scenes
+void render_batch(const Vram* const* vram, State* state, uint8_t* const* rgba, int count);
+
+// True if render_batch() runs on AVX2 on this machine
+bool batch_uses_simd();
+
+} // namespace soft_render
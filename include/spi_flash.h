@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+//
+// SPI NOR flash model
+//
+// The READ (03h) command of a serial flash in SPI mode 0, enough for the
+// PPU's boot loader (boot_loader.sv): a 32-bit command and address sampled
+// on SCK rising, then data bytes MSB first, each bit shifted out on SCK
+// falling, the address counting up until CS goes high. Anything beyond
+// `data` reads as erased (FFh). Stepped by Mud16System once per PPU cycle
+// with the pins the PPU just drove; tb_top.sv has the same model.
+//
+
+struct SpiFlash {
+    // 8 Mbit part, the size of tb_top's flash array
+    static constexpr std::size_t capacity = 1024 * 1024;
+
+    std::vector<uint8_t> data;
+    uint64_t bytes_read = 0; // bytes started on MISO, counted like tb_top
+
+    inline uint8_t tick(uint8_t cs_n, uint8_t sck, uint8_t mosi) {
+        if (cs_n) {
+            bits    = 0;
+            reading = false;
+        } else if (sck && !prev_sck && !reading && bits < 32) {
+            cmd = cmd << 1 | (mosi & 1);
+            if (++bits == 32) {
+                reading = (cmd >> 24) == 0x03;
+                addr    = cmd & 0xFFFFFF;
+                bit     = 0;
+            }
+        } else if (!sck && prev_sck && reading) {
+            if (bit == 0) {
+                cur = addr < data.size() ? data[addr] : 0xFF;
+                addr++;
+                bytes_read++;
+            }
+            miso = (cur >> (7 - bit)) & 1;
+            bit  = (bit + 1) & 7;
+        }
+        prev_sck = sck;
+        return miso;
+    }
+
+private:
+    uint32_t cmd      = 0;
+    int      bits     = 0;
+    bool     reading  = false;
+    uint32_t addr     = 0;
+    int      bit      = 0;
+    uint8_t  cur      = 0xFF;
+    uint8_t  miso     = 1;
+    uint8_t  prev_sck = 0;
+};
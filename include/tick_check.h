@@ -0,0 +1,28 @@
+#pragma once
+
+#include "mud16_system.h"
+
+#include <cstdint>
+#include <vector>
+
+//
+// Equivalence check for Mud16System's fast tick mode: runs the same RAM image
+// and CPU timing in a normal and a fast-tick system side by side and compares
+// the frame hash, cycle count and bus hold count after every frame.
+//
+
+namespace tick_check {
+
+struct Result {
+    bool     ok             = false;
+    bool     supported      = false; // false: the model has no fast tick, nothing was run
+    uint32_t frames_checked = 0;
+    uint32_t first_mismatch = 0;     // frame index, valid when !ok && supported
+    uint64_t hash_full      = 0;     // hashes at the mismatch, or of the last frame
+    uint64_t hash_fast      = 0;
+};
+
+Result run(const std::vector<uint8_t>& ram, uint32_t frames,
+           const CpuBusConfig& cpu = CpuBusConfig{});
+
+} // namespace tick_check
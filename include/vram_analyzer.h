@@ -0,0 +1,110 @@
+#pragma once
+
+#include "soft_render.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+//
+// VRAM usage analyzer
+//
+// Accumulates, over any number of frames, which parts of what the refresh
+// FSM copies in every frame can actually reach the screen: visible BG map
+// cells, the UI map, enabled on-screen objects, the tiles these reference
+// and the palette colours those tiles' pixels select. Everything else is
+// refresh bandwidth spent for nothing. Also finds duplicate tiles, counting
+// a tile that is a flipped copy of another as a duplicate.
+//
+// Cheap enough to call after every simulated frame (see mud16_analyze).
+//
+
+namespace vram_analyzer {
+
+// What the refresh FSM reads per refresh (ppu.sv with default parameters)
+struct RefreshSizes {
+    static constexpr int palette_bytes = 8 * 16 * 2;
+    static constexpr int tile_slots    = 512;
+    static constexpr int tile_bytes    = tile_slots * 32;
+    static constexpr int bg_map_bytes  = 64 * 64;
+    static constexpr int ui_map_bytes  = 40 * 10;
+    static constexpr int oam_bytes     = 128 * 4;
+    static constexpr int reg_bytes     = ppu_regs::word_count * 2;
+    static constexpr int remap_bytes   = ppu_regs::remap_entries; // with CTRL_TILE_REMAP only
+    static constexpr int anim_bytes    = 128;                     // with CTRL_SPRITE_ANIM only
+
+    // World map mode replaces the BG map copy: one 16-bit read per window cell
+    static constexpr int window_cells  = ppu_regs::window_w() * ppu_regs::window_h();
+    static constexpr int window_bytes  = window_cells * 2;
+
+    // Tile addresses are 13 bits wide in the render path, so only the first
+    // 256 slots can ever be drawn
+    static constexpr int reachable_tiles = 256;
+};
+
+enum TileUser : uint8_t {
+    USED_BY_BG  = 1,
+    USED_BY_UI  = 2,
+    USED_BY_OAM = 4,
+};
+
+struct Region {
+    const char* name;
+    int         read;  // bytes per refresh
+    int         used;  // bytes that reached the screen in at least one frame
+};
+
+struct DuplicateGroup {
+    std::vector<int> tiles; // first entry is the lowest slot
+    bool             flipped; // some members only match after a flip
+};
+
+struct Report {
+    uint64_t frames = 0;
+
+    int tiles_bg = 0, tiles_ui = 0, tiles_oam = 0, tiles_used = 0;
+    int tiles_unused_nonblank = 0; // loaded, never referenced, not all zero
+
+    std::vector<DuplicateGroup> duplicates;       // among referenced tiles
+    std::vector<int>            palettes_bg_ui;   // palettes BG/UI pixels came from
+    std::vector<int>            palettes_oam;     // palettes the OAM entries ask for
+    std::vector<int>            palettes_drawn;   // palettes object pixels really use (see below)
+
+    std::vector<Region> regions;
+    int bytes_read = 0;
+    int bytes_used = 0;
+
+    void print(FILE* out) const;
+};
+
+class Analyzer {
+public:
+    Analyzer();
+
+    // One frame's VRAM, as the refresh FSM would load it from `ram`
+    void observe(const uint8_t* ram, std::size_t ram_size);
+    void observe(const soft_render::Vram& vram);
+
+    Report report() const;
+
+private:
+    uint64_t frames = 0;
+
+    uint8_t  tile_users[RefreshSizes::tile_slots] = {};
+    bool     bg_cells[RefreshSizes::bg_map_bytes] = {};
+    bool     oam_entries[128] = {};
+    uint16_t colors[8] = {};           // per palette, bit c: colour c reached the screen
+    uint8_t  palettes_requested = 0;   // bit p: some enabled object asks for palette p
+    uint8_t  palettes_drawn = 0;
+    bool     world_map = false;        // modes of the last observed frame
+    bool     tile_remap = false;
+    bool     sprite_anim = false;
+    bool     color_cycle = false;
+    bool     remap_used[ppu_regs::remap_entries] = {};
+
+    // Tile contents from the last observed frame, for duplicate detection
+    std::vector<uint8_t> last_tiles;
+};
+
+} // namespace vram_analyzer
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "frame_hash.h"
+#include "ppu_regs.h"
+#include "vram_init_data.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+//
+// Incremental fingerprint of everything the PPU copies in at the start of a
+// frame: the vram_init::Layout regions. Writes that go through the memory
+// model mark the regions they touch; value() only rehashes those.
+//
+// The palette, tile, map and OAM regions move with the base registers;
+// value() follows them and rehashes a region whose base changed, so writes
+// to a back buffer cost nothing until the game flips to it.
+//
+// In world map mode the BG comes from a window of a map that can sit
+// anywhere in SRAM, so value() hashes the window cells themselves (about
+// 1.3K bytes) every time instead of tracking writes to the map.
+//
+// The palette select registers have no load path and keep their reset
+// value, so they need no fingerprint of their own. Sprite animation,
+// colour cycling and present on demand make frames depend on PPU-internal
+// state; animates() tells the frame cache to leave such frames alone.
+//
+
+struct VramFingerprint {
+    struct Region {
+        uint32_t base;
+        uint32_t bytes;
+    };
+
+    using L = vram_init::Layout;
+    static constexpr int region_count = 8;
+    static constexpr int relocatable  = 5; // the first five follow the base registers
+    Region regions[region_count] = {
+        {L::palette_base, L::palette_bytes},
+        {L::tile_base,    L::tile_read_bytes}, // not the 32 KB reserved, which covers the maps and OAM
+        {L::bg_map_base,  L::bg_map_bytes},
+        {L::ui_map_base,  L::ui_map_bytes},
+        {L::oam_base,     L::oam_bytes},
+        {L::reg_base,     L::reg_bytes},
+        {L::remap_base,   L::remap_bytes},
+        {L::anim_base,    L::anim_bytes},
+    };
+
+    uint64_t hashes[region_count] = {};
+    bool     dirty[region_count];
+    uint64_t rehashed = 0; // regions hashed again since construction
+
+    VramFingerprint() { invalidate(); }
+
+    void invalidate() {
+        for (bool& d : dirty) d = true;
+    }
+
+    // Called by the memory model for every write to RAM
+    inline void note_write(uint32_t addr, std::size_t len) {
+        for (int r = 0; r < region_count; r++) {
+            if (addr < regions[r].base + regions[r].bytes && addr + len > regions[r].base) dirty[r] = true;
+        }
+    }
+
+    static bool animates(const uint8_t* ram, std::size_t ram_size) {
+        const ppu_regs::Regs regs = ppu_regs::Regs::from_ram(ram, ram_size);
+        return regs.sprite_anim() || regs.color_cycle() || regs.present_on_demand() || regs.te_sync();
+    }
+
+    uint64_t value(const uint8_t* ram, std::size_t ram_size) {
+        const ppu_regs::Regs regs = ppu_regs::Regs::from_ram(ram, ram_size);
+        const uint32_t bases[relocatable] = {
+            regs.palette_base(), regs.tile_base(), regs.bg_map_base(), regs.ui_map_base(), regs.oam_base(),
+        };
+        for (int r = 0; r < relocatable; r++) {
+            if (regions[r].base != bases[r]) {
+                regions[r].base = bases[r];
+                dirty[r]        = true;
+            }
+        }
+
+        uint64_t h = 0;
+        for (int r = 0; r < region_count; r++) {
+            if (dirty[r]) {
+                std::size_t len = regions[r].base < ram_size
+                                ? std::min<std::size_t>(regions[r].bytes, ram_size - regions[r].base) : 0;
+                hashes[r] = frame_hash::hash64(ram + regions[r].base, len, r);
+                dirty[r]  = false;
+                rehashed++;
+            }
+            h = frame_hash::hash64(reinterpret_cast<const uint8_t*>(&hashes[r]), sizeof(hashes[r]), h);
+        }
+
+        if (regs.world_map()) {
+            uint8_t window[64 * 64];
+            int     n = 0;
+            for (int wy = 0; wy < ppu_regs::window_h(); wy++) {
+                for (int wx = 0; wx < ppu_regs::window_w(); wx++) window[n++] = regs.world_tile(ram, ram_size, wx, wy);
+            }
+            h = frame_hash::hash64(window, static_cast<std::size_t>(n), h);
+        }
+        return h;
+    }
+};
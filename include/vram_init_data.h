@@ -12,7 +12,10 @@
 // 0x05000–0x05FFF : BG map   (64×64 = 4096 bytes)
 // 0x06000–0x06FFF : UI map   (40×10 = 400 bytes; padded to 4 KB)
 // 0x07000–0x073FF : OAM      (128 × 4-byte entries = 512 bytes; padded to 1 KB)
-// 0x08000–...     : game stuff idk
+// 0x07400–0x074FF : PPU registers (see ppu_regs.h)
+// 0x07800–0x078FF : tile remap table (256 bytes, with CTRL_TILE_REMAP)
+// 0x07C00–0x07C7F : sprite animation descriptors (1 byte per OAM entry, with CTRL_SPRITE_ANIM)
+// 0x08000–...     : game stuff idk (the world map scene keeps its map at 0x10000)
 //
 
 namespace vram_init {
@@ -23,6 +26,7 @@ struct Layout {
 
     static constexpr uint32_t tile_base      = 0x01000;
     static constexpr uint32_t tile_bytes     = 0x008000; // 32 KB reserved
+    static constexpr uint32_t tile_read_bytes = 0x04000; // 512 tiles, what the refresh copies
 
     static constexpr uint32_t bg_map_base    = 0x05000;
     static constexpr uint32_t bg_map_bytes   = 0x01000; // 4 KB
@@ -32,6 +36,17 @@ struct Layout {
 
     static constexpr uint32_t oam_base       = 0x07000;
     static constexpr uint32_t oam_bytes      = 0x00400; // 1 KB padded
+
+    static constexpr uint32_t reg_base       = 0x07400;
+    static constexpr uint32_t reg_bytes      = 0x00100;
+
+    static constexpr uint32_t remap_base     = 0x07800;
+    static constexpr uint32_t remap_bytes    = 0x00100;
+
+    static constexpr uint32_t anim_base      = 0x07C00;
+    static constexpr uint32_t anim_bytes     = 0x00100;
+
+    static constexpr uint32_t world_map_base = 0x10000; // load_world() only, any address works
 };
 
 // High-level content descriptors
@@ -58,4 +73,51 @@ struct Params {
 void load(std::vector<uint8_t>& ram);
 void load(uint8_t* ram, std::size_t ram_size);
 
+// Worst case for the renderer: the demo palettes and tiles, a BG map with
+// every cell filled and all OAM entries enabled and spread over the screen
+void load_stress(std::vector<uint8_t>& ram);
+void load_stress(uint8_t* ram, std::size_t ram_size);
+
+// The demo scene in world map mode: a 256x64-tile world at
+// Layout::world_map_base, scrolled to (scroll_x, scroll_y)
+void load_world(std::vector<uint8_t>& ram, uint16_t scroll_x = 0, uint16_t scroll_y = 0);
+void load_world(uint8_t* ram, std::size_t ram_size, uint16_t scroll_x = 0, uint16_t scroll_y = 0);
+
+// Sets CTRL_TILE_REMAP and fills the remap table with the identity, so a
+// single byte written to Layout::remap_base + t later swaps every BG/UI
+// instance of tile t
+void enable_tile_remap(std::vector<uint8_t>& ram);
+void enable_tile_remap(uint8_t* ram, std::size_t ram_size);
+
+// Sets CTRL_SPRITE_ANIM and gives every OAM entry the descriptor `desc`
+// (ppu_regs::anim_desc)
+void enable_sprite_anim(std::vector<uint8_t>& ram, uint8_t desc);
+void enable_sprite_anim(uint8_t* ram, std::size_t ram_size, uint8_t desc);
+
+// Points base register `reg` (ppu_regs::PALETTE_BASE .. OAM_BASE) at SRAM
+// byte address `addr` (16-byte aligned); the PPU switches at the next vblank
+void set_base(std::vector<uint8_t>& ram, int reg, uint32_t addr);
+void set_base(uint8_t* ram, std::size_t ram_size, int reg, uint32_t addr);
+
+// Sets CTRL_PRESENT; from then on the PPU only renders and sends a frame
+// after ppu_regs::PRESENT changed. Leaves PRESENT one ahead of the PPU's
+// reset value so the first frame still shows.
+void enable_present_on_demand(std::vector<uint8_t>& ram);
+void enable_present_on_demand(uint8_t* ram, std::size_t ram_size);
+
+// Sets CTRL_TE_SYNC: every frame starts at the display's TE
+void enable_te_sync(std::vector<uint8_t>& ram);
+void enable_te_sync(uint8_t* ram, std::size_t ram_size);
+
+// Sets CTRL_COLOR_CYCLE and colour cycle range `range` (0 or 1) to `reg`
+// (ppu_regs::color_cycle)
+void enable_color_cycle(std::vector<uint8_t>& ram, int range, uint16_t reg);
+void enable_color_cycle(uint8_t* ram, std::size_t ram_size, int range, uint16_t reg);
+
+// The stress BG with all 128 OAM entries as enemies walking in a 16x8 grid:
+// two-frame blob animations (tiles 15-16) at 4 to 11 vblanks per frame,
+// descriptors written but CTRL_SPRITE_ANIM left off (see mud16_animbench)
+void load_enemies(std::vector<uint8_t>& ram);
+void load_enemies(uint8_t* ram, std::size_t ram_size);
+
 } // namespace vram_init
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "raylib.h"
+#include "vram_init_data.h"
+
+#include <cstdint>
+#include <cstddef>
+
+class Vppu;
+
+//
+// VRAM inspector
+//
+// Debug panels that show the VRAM regions twice: once decoded from the
+// testbench RAM and once from the copies the PPU keeps internally (read
+// through --public-flat-rw). Entries that differ are outlined in red, so a
+// bad scene can be blamed on RAM content or on the refresh FSM.
+//
+// F1 tiles, F2 palettes, F3 BG map, F4 UI map, F5 OAM
+//
+
+namespace vram_inspect {
+
+// Sizes of the internal PPU copies (see ppu.sv)
+struct Sizes {
+    static constexpr int tiles       = 512;
+    static constexpr int tile_bytes  = tiles * vram_init::Params::bytes_per_tile;
+    static constexpr int bg_cells    = vram_init::Params::bg_map_w_tiles * vram_init::Params::bg_map_h_tiles;
+    static constexpr int ui_cells    = vram_init::Params::ui_map_w_tiles * vram_init::Params::ui_map_h_tiles;
+};
+
+struct Snapshot {
+    uint16_t palette[vram_init::Params::palette_count][vram_init::Params::colors_per_palette];
+    uint8_t  tiles[Sizes::tile_bytes];
+    uint8_t  bg_map[Sizes::bg_cells];
+    uint8_t  ui_map[Sizes::ui_cells];
+    uint32_t oam[vram_init::Params::oam_entries];
+
+    // World map mode (from_ram only): bg_map holds the window the refresh
+    // fetches, at the window's cells of the 64x64 map, and the rest is 0
+    bool world_map = false;
+
+    // Decode from the shared RAM, using vram_init::Layout
+    void from_ram(const uint8_t* ram, std::size_t ram_size);
+
+    // Copy the PPU's internal arrays
+    void from_ppu(const Vppu& ppu);
+};
+
+class Inspector {
+public:
+    enum Panel {
+        PANEL_TILES,
+        PANEL_PALETTES,
+        PANEL_BG_MAP,
+        PANEL_UI_MAP,
+        PANEL_OAM,
+        PANEL_COUNT
+    };
+
+    // Panels are re-captured every `refresh_interval` presented frames
+    explicit Inspector(int refresh_interval = 15);
+    ~Inspector();
+
+    Inspector(const Inspector&) = delete;
+    Inspector& operator=(const Inspector&) = delete;
+
+    void handle_input();
+    bool any_visible() const;
+
+    // Call once per presented frame. Only copies and redraws when a panel is
+    // visible and the refresh interval has elapsed.
+    void update(const uint8_t* ram, std::size_t ram_size, const Vppu& ppu);
+
+    void draw(int x, int y) const;
+
+private:
+    void capture(const uint8_t* ram, std::size_t ram_size, const Vppu& ppu);
+    void rebuild_images();
+
+    void draw_tiles(int x, int y) const;
+    void draw_palettes(int x, int y) const;
+    void draw_bg_map(int x, int y) const;
+    void draw_ui_map(int x, int y) const;
+    void draw_oam(int x, int y) const;
+
+    int panel_height(Panel p) const;
+
+    int  refresh_interval;
+    int  frame_counter = 0;
+    bool visible[PANEL_COUNT] = {};
+    bool textures_ready = false;
+
+    Snapshot* from_ram_snap;
+    Snapshot* from_ppu_snap;
+
+    // [0] = RAM, [1] = PPU
+    Image     tile_image[2];
+    Texture2D tile_texture[2];
+    Image     bg_image[2];
+    Texture2D bg_texture[2];
+    Image     ui_image[2];
+    Texture2D ui_texture[2];
+
+    // Per-entry difference flags
+    bool tile_diff[Sizes::tiles];
+    bool palette_diff[vram_init::Params::palette_count][vram_init::Params::colors_per_palette];
+    bool bg_diff[Sizes::bg_cells];
+    bool ui_diff[Sizes::ui_cells];
+    bool oam_diff[vram_init::Params::oam_entries];
+    int  diff_count[PANEL_COUNT] = {};
+};
+
+} // namespace vram_inspect